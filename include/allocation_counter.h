@@ -0,0 +1,65 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: allocation_counter.h
+ * Description: describes the heap allocation counter used to profile the rendering
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _ALLOCATION_COUNTER_H_
+#define _ALLOCATION_COUNTER_H_
+
+#include <cstddef>
+
+/**
+ * @brief get_allocation_count
+ *
+ * The global operator new is replaced by a counting one (see
+ * allocation_counter.cpp) when this module is linked.
+ *
+ * @return the number of heap allocations done since the start of the program
+ */
+size_t	get_allocation_count();
+
+/**
+ * @brief The Allocation_Counter class
+ *
+ * Counts the heap allocations done during its lifetime, by any thread.
+ */
+class Allocation_Counter {
+public:
+	Allocation_Counter() : _start(get_allocation_count()) {
+	}
+
+	/**
+	 * @brief count
+	 * @return the number of allocations done since the object was created
+	 */
+	size_t	count() const {
+		return get_allocation_count() - this->_start;
+	}
+
+private:
+	size_t	_start;
+};
+
+#endif // _ALLOCATION_COUNTER_H_
@@ -0,0 +1,238 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: bench.h
+ * Description: describes the rendering benchmark
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <sys/stat.h>
+
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/program_options.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/regex.hpp>
+
+#include "allocation_counter.h"
+#include "printing.h"
+#include "job_set.h"
+#include "definition_file.h"
+
+/**
+ * The number of mutated lines gathered into a definition stream by the fuzzer
+ */
+#define FUZZ_STREAM_INPUTS	64
+
+/**
+ * The fuzzed streams are also split into parts of this size, parsed by
+ * FUZZ_THREADS threads, and must give the same definitions
+ */
+#define FUZZ_CHUNK_SIZE		256
+#define FUZZ_THREADS		4
+
+/**
+ * @brief The s_planning struct
+ *
+ * A synthetic planning: the same jobs are available as a list and spread
+ * over the nodes
+ */
+struct s_planning {
+	rpc::v_nodes	nodes;
+	rpc::v_jobs		jobs;
+	m_kv			kv;
+};
+
+/**
+ * @brief The s_bench_result struct
+ *
+ * The best run of an entry point
+ */
+struct s_bench_result {
+	double	ns_per_job;
+	double	bytes_per_second;
+	double	allocations_per_job;
+	size_t	bytes;
+};
+
+/**
+ * A print_* entry point rendering the whole planning
+ */
+typedef void (*bench_function)(const s_printing_options& opts, const s_planning& planning);
+
+/**
+ * @brief The s_attribute_lines struct
+ *
+ * The attributes of a planning as definition lines
+ */
+struct s_attribute_lines {
+	std::vector<std::string>	jobs;
+	std::vector<std::string>	nodes;
+
+	// The time constraints' values as hhmm
+	std::vector<std::string>	times;
+};
+
+/**
+ * A split_line implementation, returns the number of keys found
+ */
+typedef size_t (*parser_function)(const std::vector<std::string>& lines);
+
+/**
+ * An enum conversion applied to the jobs, returns the number of conversions
+ */
+typedef size_t (*conversion_function)(const rpc::v_jobs& jobs);
+
+/**
+ * @brief build_planning
+ *
+ * Generates a planning, the pseudo-random choices are the same for every run
+ *
+ * @param jobs_count	the number of jobs
+ * @param jobs_per_node	the number of jobs of each node
+ * @param fan_out		the average number of nxt and prv links of a job
+ * @param planning		the result
+ */
+void	build_planning(const size_t& jobs_count, const size_t& jobs_per_node, const size_t& fan_out, s_planning& planning);
+
+/**
+ * @brief run_bench
+ *
+ * Runs the entry point several times, the output is written to stdout which
+ * must be a regular file
+ *
+ * @param opts			the printing options
+ * @param planning		the data to render
+ * @param function		the entry point
+ * @param iterations	the number of runs
+ * @param result		the best run
+ *
+ * @return false if the output cannot be measured
+ */
+bool	run_bench(const s_printing_options& opts, const s_planning& planning, bench_function function, const size_t& iterations, s_bench_result& result);
+
+/**
+ * @brief build_definition_lines
+ *
+ * Writes the jobs of the planning as key = value lines, with comments and
+ * blank lines
+ */
+void	build_definition_lines(const s_planning& planning, std::vector<std::string>& lines);
+
+/**
+ * @brief bench_parsers
+ *
+ * Prints the number of lines per second parsed by each split_line
+ * implementation
+ *
+ * @return false if a parser fails
+ */
+bool	bench_parsers(const std::vector<size_t>& sizes, const size_t& jobs_per_node, const size_t& fan_out, const size_t& iterations);
+
+/**
+ * @brief bench_conversions
+ *
+ * Prints the number of conversions per second and the allocations done by
+ * the former convertions functions and by the static tables
+ *
+ * @return false if nothing has been converted
+ */
+bool	bench_conversions(const std::vector<size_t>& sizes, const size_t& jobs_per_node, const size_t& fan_out, const size_t& iterations);
+
+/**
+ * @brief jobs_memory
+ * @return the approximate number of bytes used by the jobs and their strings
+ */
+size_t	jobs_memory(const rpc::v_jobs& jobs);
+
+/**
+ * @brief bench_interning
+ *
+ * Prints the memory used by the plannings' jobs as rpc::v_jobs and as a
+ * Job_Set, and checks that the interned jobs come back unchanged
+ *
+ * @return false if a job differs once interned
+ */
+bool	bench_interning(const std::vector<size_t>& sizes, const size_t& jobs_per_node, const size_t& fan_out);
+
+/**
+ * @brief build_attribute_lines
+ *
+ * Writes every attribute of the planning's jobs and nodes as key = value
+ * lines, the time constraints use hhmm values
+ */
+void	build_attribute_lines(const s_planning& planning, s_attribute_lines& lines);
+
+/**
+ * @brief build_json_documents
+ *
+ * Writes every job and every node of the planning, with its jobs, as a JSON
+ * object on one line, with the members read by read_json_job and
+ * read_json_node
+ */
+void	build_json_documents(const s_planning& planning, std::vector<std::string>& documents);
+
+/**
+ * @brief bench_attributes
+ *
+ * Prints the throughput and the cost per attribute of split_line, of the
+ * former and current update_job and update_node, and of the hh:mm parsers
+ *
+ * @return true
+ */
+bool	bench_attributes(const std::vector<size_t>& sizes, const size_t& jobs_per_node, const size_t& fan_out, const size_t& iterations);
+
+/**
+ * @brief bench_fuzz
+ *
+ * Mutates valid attributes and JSON documents and gives them to the former
+ * and current parsers, then prints what each one did. The current parsers may
+ * only reject the inputs or throw std::invalid_argument and
+ * boost::bad_lexical_cast; the failing inputs are printed.
+ *
+ * @param inputs_count	the number of mutated attributes and documents
+ * @param seed			the same seed gives the same inputs
+ *
+ * @return false if a current parser failed
+ */
+bool	bench_fuzz(const size_t& inputs_count, const uint32_t& seed);
+
+/**
+ * main
+ *
+ * @param	argc : the number of arguments
+ * @param	argv : the arguments
+ *
+ * @return	EXIT_SUCCESS or EXIT_FAILURE
+ */
+int	main(const int argc, char const* argv[]);
+
+#endif // _BENCH_H_
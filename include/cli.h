@@ -29,14 +29,24 @@
 #include <fstream>
 #include <iostream>
 #include <algorithm>
+#include <csignal>
+#include <unistd.h>
 
 #include <boost/foreach.hpp>
 #include <boost/regex.hpp>
 #include <boost/program_options.hpp>
 
 #include "libcli.h"
+#include "allocation_counter.h"
 #include "printing.h"
 #include "rpc_client.h"
+#include "definition_file.h"
+#include "job_import.h"
+#include "node_fan_out.h"
+#include "connection_pool.h"
+#include "rpc_cache.h"
+#include "job_watch.h"
+#include "job_query.h"
 
 s_printing_options print_opts;
 
@@ -51,15 +61,44 @@ s_printing_options print_opts;
  */
 bool	cli_add_commands(struct cli_def* cli);
 
+/**
+ * pool
+ *
+ * The connections released by the commands, reused by the next ones
+ */
+Connection_Pool	pool;
+
 /**
  * client
  *
  * This object represents the connection against the node. It needs to be global
- * to be seen by the "cmd_*" functions.
+ * to be seen by the "cmd_*" functions. It is borrowed from the pool.
+ */
+Pooled_Client	client(pool);
+
+/**
+ * cache
+ *
+ * The answers of the read requests, invalidated by the successful writes
  */
-Rpc_Client	client;
+Rpc_Cache	cache;
+
 rpc::t_routing_data    routing;
 
+/**
+ * The endpoint given to the connect command, used to open more connections
+ */
+std::string	connected_hostname;
+int			connected_port = 8080;
+
+/**
+ * The state of the watch command, used by its regular callback
+ */
+Job_Watch				watch;
+s_printing_options		watch_opts;
+size_t					watch_remaining = 0;
+volatile sig_atomic_t	watch_interrupted = 0;
+
 #ifdef __GNUC__
 #define UNUSED(d) d __attribute__ ((unused))
 #else
@@ -75,9 +114,11 @@ rpc::t_routing_data    routing;
  *
  * Implements the get_nodes RPC call
  *
+ * @arg	argv	the printing arguments (fields=<list>)
+ * @arg argc	the number of arguments
  * @return	CLI_OK or CLI_ERROR
  */
-int	cmd_get_nodes(UNUSED(struct cli_def *cli), const char *command, UNUSED(char *argv[]), UNUSED(int argc));
+int	cmd_get_nodes(UNUSED(struct cli_def *cli), const char *command, char *argv[], int argc);
 
 /**
  * cmd_add_node
@@ -143,18 +184,69 @@ int	cmd_update_job(UNUSED(struct cli_def *cli), const char *command, char *argv[
  *
  * Implements the get_ready_jobs RPC call
  *
+ * @arg	argv	the printing arguments (fields=<list>)
+ * @arg argc	the number of arguments
  * @return	CLI_OK or CLI_ERROR
  */
-int	cmd_get_ready_jobs(UNUSED(struct cli_def *cli), const char *command, UNUSED(char *argv[]), UNUSED(int argc));
+int	cmd_get_ready_jobs(UNUSED(struct cli_def *cli), const char *command, char *argv[], int argc);
 
 /**
  * cmd_get_jobs
  *
  * Implements the get_jobs RPC call
  *
+ * "all-nodes" as first argument gets the jobs of every node of the domain:
+ * get_nodes is called once then the nodes are requested in parallel, on the
+ * connected port, by workers=<number> threads. The jobs are printed as one
+ * list tagged by their node_name.
+ *
+ * "where" keeps the jobs matching the following predicates, before they are
+ * printed: state=<states>, node=<names> and name=<names>. The values are
+ * separated by ',' and a name ending with '*' is a prefix, e.g.
+ * get jobs where state=failed node=web* name=etl_*
+ *
+ * @arg	argv	[all-nodes [workers=<number>]] [where <predicates>] then the printing arguments (fields=<list>)
+ * @arg argc	the number of arguments
+ * @return	CLI_OK or CLI_ERROR
+ */
+int	cmd_get_jobs(UNUSED(struct cli_def *cli), const char *command, char *argv[], int argc);
+
+/**
+ * get_domain_jobs
+ *
+ * Gets the jobs of every node of the domain, see cmd_get_jobs
+ *
+ * @arg	argv	the arguments following all-nodes
+ * @arg argc	the number of arguments
  * @return	CLI_OK or CLI_ERROR
  */
-int	cmd_get_jobs(UNUSED(struct cli_def *cli), const char *command, UNUSED(char *argv[]), UNUSED(int argc));
+int	get_domain_jobs(char *argv[], int argc);
+
+/**
+ * parse_query_arguments
+ *
+ * Compiles the predicates following "where", see cmd_get_jobs
+ *
+ * @arg	argv	the arguments
+ * @arg argc	the number of arguments
+ * @arg	query	the compiled predicates
+ * @arg	others	the other arguments
+ * @return	false if a predicate is not valid
+ */
+bool	parse_query_arguments(char *argv[], int argc, s_job_query& query, std::vector<char*>& others);
+
+/**
+ * cmd_import_jobs
+ *
+ * Adds the jobs of a definition file using a pool of connections. The file
+ * holds key=value blocks or JSON objects (a document, an array or NDJSON).
+ *
+ * @arg	argv	the file's path then connections=<number> and threads=<number>, the
+ *				number of parsing threads
+ * @arg argc	the number of arguments
+ * @return	CLI_OK or CLI_ERROR
+ */
+int	cmd_import_jobs(UNUSED(struct cli_def *cli), const char *command, char *argv[], int argc);
 
 /**
  * cmd_update_job_state
@@ -167,6 +259,35 @@ int	cmd_get_jobs(UNUSED(struct cli_def *cli), const char *command, UNUSED(char *
  */
 int	cmd_update_job_state(UNUSED(struct cli_def *cli), const char *command, char *argv[], int argc);
 
+/**
+ * cmd_watch_jobs
+ *
+ * Polls get_jobs until Ctrl-C and prints the jobs added, removed or changed
+ * (state, return code, start or stop time) since the previous poll.
+ * The first poll prints every job.
+ *
+ * @arg	argv	[interval in seconds] [count=<polls>] then the printing arguments (fields=<list>)
+ * @arg argc	the number of arguments
+ * @return	CLI_OK or CLI_ERROR
+ */
+int	cmd_watch_jobs(struct cli_def *cli, const char *command, char *argv[], int argc);
+
+/**
+ * watch_jobs_tick
+ *
+ * The regular callback of cmd_watch_jobs: one poll
+ *
+ * @return	CLI_OK to go on, CLI_QUIT when the watch is over, CLI_ERROR
+ */
+int	watch_jobs_tick(UNUSED(struct cli_def *cli));
+
+/**
+ * print_job_changes
+ *
+ * Prints each non-empty group of jobs after a header giving its change
+ */
+void	print_job_changes(const s_printing_options& opts, const s_job_changes& changes);
+
 // ////////////////////////////////////////////////////////////////////////////
 //	planning
 // ////////////////////////////////////////////////////////////////////////////
@@ -261,6 +382,43 @@ int	cmd_close(struct cli_def *cli, const char *command, UNUSED(char *argv[]), UN
  */
 int	cmd_hello(UNUSED(struct cli_def *cli), const char *command, UNUSED(char *argv[]), UNUSED(int argc));
 
+/**
+ * cmd_load
+ *
+ * Prints the snapshots written by the binary output type
+ *
+ * @arg	argv	the file's path ("-" for stdin) then the printing arguments
+ * @arg argc	the number of arguments
+ * @return	CLI_OK or CLI_ERROR
+ */
+int	cmd_load(UNUSED(struct cli_def *cli), const char *command, char *argv[], int argc);
+
+/**
+ * load_snapshots
+ *
+ * Reads the snapshots of the file and prints them, one after the other in
+ * opts.output_file if it is set
+ *
+ * @arg	opts	the printing options
+ * @arg	path	the file's path, "-" for stdin
+ *
+ * @return	true on success
+ */
+bool	load_snapshots(const s_printing_options& opts, const char* path);
+
+/**
+ * parse_printing_arguments
+ *
+ * Updates the printing options using the command's arguments
+ *
+ * @arg	argv	the arguments (fields=<list>, file=<path>)
+ * @arg argc	the number of arguments
+ * @arg	opts	the options to update
+ *
+ * @return	true on success
+ */
+bool	parse_printing_arguments(char *argv[], int argc, s_printing_options& opts);
+
 /**
  * clear_node
  *
@@ -268,7 +426,7 @@ int	cmd_hello(UNUSED(struct cli_def *cli), const char *command, UNUSED(char *arg
  *
  * @arg	the node to clear
  */
-void	clear_node(rpc::t_node _return);
+void	clear_node(rpc::t_node& _return);
 
 /**
  * set_prompt
@@ -0,0 +1,225 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: connection_pool.h
+ * Description: describes the pool of connections to the nodes
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _CONNECTION_POOL_H_
+#define _CONNECTION_POOL_H_
+
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <string>
+#include <boost/foreach.hpp>
+#include <boost/thread.hpp>
+
+#include "rpc_client.h"
+
+/**
+ * The number of idle connections kept open
+ */
+#define POOL_MAX_IDLE	256
+
+/**
+ * An idle connection is checked by a hello request after this number of
+ * seconds
+ */
+#define POOL_IDLE_CHECK	30
+
+/**
+ * @brief The s_endpoint struct
+ *
+ * What a connection is opened for
+ */
+struct s_endpoint {
+	s_endpoint() : port(0) {
+	}
+
+	s_endpoint(const std::string& h, const int& p, const std::string& d) : hostname(h), port(p), domain(d) {
+	}
+
+	bool	operator==(const s_endpoint& other) const {
+		return this->port == other.port && this->hostname == other.hostname && this->domain == other.domain;
+	}
+
+	std::string	hostname;
+	int			port;
+	std::string	domain;
+};
+
+/**
+ * @brief The s_connection struct
+ *
+ * An open connection and the last hello answer of its node
+ */
+struct s_connection {
+	s_connection() : broken(false), has_hello(false) {
+	}
+
+	s_endpoint								endpoint;
+	Rpc_Client								client;
+
+	// The last time the connection was known to work
+	std::chrono::steady_clock::time_point	used;
+
+	// Set after a transport error: the connection is closed when released
+	bool									broken;
+
+	bool									has_hello;
+	rpc::t_hello							hello;
+};
+
+/**
+ * @brief The s_pool_stats struct
+ */
+struct s_pool_stats {
+	size_t	opened;		// new connections
+	size_t	reused;		// idle connections handed out without a check
+	size_t	checked;	// idle connections handed out after a hello
+	size_t	dropped;	// idle connections which failed their hello
+};
+
+/**
+ * @brief The Connection_Pool class
+ *
+ * Keeps the connections released by the commands and hands them out again
+ * to the next ones for the same endpoint: the most recently used first. A
+ * connection idle for more than the check period is tested with a hello
+ * request before being handed out. When too many connections are idle, the
+ * least recently used one is closed.
+ *
+ * The pool is thread-safe: the requests are not sent under its lock.
+ */
+class Connection_Pool {
+public:
+	/**
+	 * @brief Connection_Pool
+	 * @param max_idle		the number of idle connections kept
+	 * @param idle_check	the idle seconds after which a connection is checked
+	 */
+	Connection_Pool(const size_t& max_idle = POOL_MAX_IDLE, const size_t& idle_check = POOL_IDLE_CHECK);
+	~Connection_Pool();
+
+	/**
+	 * @brief acquire
+	 *
+	 * Takes an idle connection to the endpoint or opens a new one
+	 *
+	 * @return NULL if no connection can be opened
+	 */
+	std::unique_ptr<s_connection>	acquire(const s_endpoint& endpoint);
+
+	/**
+	 * @brief release
+	 *
+	 * Gives back a connection, it is closed if it is broken
+	 */
+	void	release(std::unique_ptr<s_connection> connection);
+
+	/**
+	 * @brief close
+	 *
+	 * Closes a connection which must not be reused
+	 */
+	void	close(std::unique_ptr<s_connection> connection);
+
+	/**
+	 * @brief clear
+	 *
+	 * Closes the idle connections
+	 */
+	void	clear();
+
+	void			set_idle_check(const size_t& seconds);
+	s_pool_stats	stats();
+
+private:
+	/**
+	 * @brief check
+	 *
+	 * Sends a hello request, the answer is kept in the connection
+	 *
+	 * @return false if the connection does not work
+	 */
+	bool	check(s_connection& connection);
+
+	size_t									_max_idle;
+	std::chrono::steady_clock::duration		_idle_check;
+
+	boost::mutex							_mutex;
+
+	// The least recently used first
+	std::list<std::unique_ptr<s_connection> >	_idle;
+
+	s_pool_stats							_stats;
+};
+
+/**
+ * @brief The Pooled_Client class
+ *
+ * A connection borrowed from a pool, it has the interface of Rpc_Client:
+ * close() gives the connection back instead of closing it
+ */
+class Pooled_Client {
+public:
+	Pooled_Client(Connection_Pool& pool);
+	~Pooled_Client();
+
+	/**
+	 * @brief open
+	 *
+	 * Gives back the current connection then borrows one to the endpoint
+	 *
+	 * @param domain	the domain the connection is used for
+	 */
+	bool	open(const std::string& hostname, const int& port, const std::string& domain);
+	bool	close();
+
+	/**
+	 * @brief set_broken
+	 *
+	 * Called after a transport error: the connection will be closed instead
+	 * of given back
+	 */
+	void	set_broken();
+
+	rpc::ows_rpcClient*	get_handler();
+
+	/**
+	 * @brief hello
+	 *
+	 * @return the node's last hello answer, NULL if none is known
+	 */
+	const rpc::t_hello*	hello() const;
+	void				set_hello(const rpc::t_hello& hello);
+
+private:
+	Connection_Pool&				_pool;
+	std::unique_ptr<s_connection>	_connection;
+};
+
+#endif // _CONNECTION_POOL_H_
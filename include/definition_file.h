@@ -0,0 +1,267 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: definition_file.h
+ * Description: describes the reader of the definition files
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _DEFINITION_FILE_H_
+#define _DEFINITION_FILE_H_
+
+#include <string>
+#include <vector>
+#include <boost/bind/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+#include <boost/utility/string_view.hpp>
+
+#include "json_reader.h"
+#include "text_processing.h"
+
+/**
+ * The size of the parts of a definition file given to the parsing threads
+ */
+#define DEFINITION_CHUNK_SIZE	262144
+
+/**
+ * The number of jobs and errors of a JSON file handed over at once
+ */
+#define DEFINITION_JSON_BATCH	1024
+
+/**
+ * @brief The s_definition_error struct
+ */
+struct s_definition_error {
+	size_t		line;
+	std::string	message;
+};
+
+typedef std::vector<s_definition_error>	v_definition_errors;
+
+/**
+ * @brief The s_job_definitions struct
+ *
+ * The result of the parsing of a whole definition file
+ */
+struct s_job_definitions {
+	std::vector<rpc::t_job>	jobs;		// the valid blocks, in file order
+	size_t					invalid;	// the blocks having at least one error
+	v_definition_errors		errors;		// in file order
+};
+
+/**
+ * Receives the definitions of a part of a file, the jobs can be moved out
+ */
+typedef boost::function<void (s_job_definitions&)>	job_definitions_handler;
+
+/**
+ * @brief The Definition_File class
+ *
+ * Gives the lines of a definition file without copying them: regular files
+ * are mapped in memory, the other inputs (pipes, terminals) are read at once.
+ * The lines are slices of the mapping and stay valid until the object is
+ * destroyed.
+ */
+class Definition_File {
+public:
+	Definition_File();
+	~Definition_File();
+
+	/**
+	 * @brief open
+	 * @param path	the file to read, "-" for stdin
+	 * @return false if the file cannot be read
+	 */
+	bool	open(const std::string& path);
+
+	/**
+	 * @brief open
+	 * @param fd	an opened file descriptor, it is not closed
+	 * @return false if the file cannot be read
+	 */
+	bool	open(const int& fd);
+
+	/**
+	 * @brief open
+	 *
+	 * Reads a part of another file: nothing is copied, the memory must stay
+	 * valid while the lines are used
+	 *
+	 * @param data			the first character of the part
+	 * @param size			the size of the part
+	 * @param line_number	the number of the lines before the part
+	 */
+	void	open(const char* data, const size_t& size, const size_t& line_number);
+
+	/**
+	 * @brief next_line
+	 * @param line	the next line, without its end of line character
+	 * @return false at the end of the file
+	 */
+	bool	next_line(boost::string_view& line);
+
+	/**
+	 * @brief line_number
+	 * @return the number of the last line given by next_line
+	 */
+	size_t	line_number() const;
+
+	const char*	data() const;
+	size_t		size() const;
+
+private:
+	void	close();
+
+	const char*			_data;
+	size_t				_size;
+	bool				_mapped;
+	std::vector<char>	_buffer;
+
+	size_t				_position;
+	size_t				_line_number;
+};
+
+/**
+ * read_job_block
+ *
+ * Reads the next job of a definition file: its key=value lines end at a
+ * blank line or at the end of the file. The comment lines are ignored.
+ *
+ * @param	file	the file to read
+ * @param	job	the job to update
+ * @param	found	set to true if the block has at least one line
+ * @param	errors	the invalid lines of the block are appended
+ * @param	cache	the times resolved by the previous blocks, see update_job
+ *
+ * @return	false if a line of the block is invalid
+ */
+bool	read_job_block(Definition_File& file, rpc::t_job& job, bool& found, v_definition_errors& errors, Hhmm_Cache* cache = NULL);
+
+/**
+ * read_node_block
+ *
+ * Same as read_job_block for a node
+ */
+bool	read_node_block(Definition_File& file, rpc::t_node& node, bool& found, v_definition_errors& errors);
+
+/**
+ * read_json_job
+ *
+ * Fills the job with a JSON object, the members have the names used by the
+ * key=value definitions and by the JSON output. nxt, prv, recovery_type and
+ * time_constraints can be given as arrays and objects or as strings.
+ *
+ * @param	reader	the object is the next value
+ * @param	job		the job to update
+ * @param	valid	set to false if a member is invalid or unknown
+ * @param	errors	the invalid members are appended
+ * @param	cache	the times resolved by the previous jobs
+ *
+ * @return	false on a syntax error, see reader.error()
+ */
+bool	read_json_job(Json_Reader& reader, rpc::t_job& job, bool& valid, v_definition_errors& errors, Hhmm_Cache* cache);
+
+/**
+ * read_json_node
+ *
+ * Same as read_json_job for a node, its jobs and resources are arrays of
+ * objects
+ */
+bool	read_json_node(Json_Reader& reader, rpc::t_node& node, bool& valid, v_definition_errors& errors, Hhmm_Cache* cache);
+
+/**
+ * is_json
+ *
+ * @return	true if the file is a JSON document or stream
+ */
+bool	is_json(const Definition_File& file);
+
+/**
+ * read_json_definitions
+ *
+ * Reads the jobs of a JSON file: objects, arrays of objects or a stream of
+ * them (NDJSON). A syntax error stops the reading.
+ */
+void	read_json_definitions(const Definition_File& file, const std::string& domain, s_job_definitions& result);
+
+/**
+ * read_json_definitions
+ *
+ * Same as above, the jobs and the errors are handed over by batches of
+ * DEFINITION_JSON_BATCH
+ */
+void	read_json_definitions(const Definition_File& file, const std::string& domain, const job_definitions_handler& handler);
+
+/**
+ * read_job_definition
+ *
+ * Reads the first job of the file, which can be a key=value block or a JSON
+ * document
+ *
+ * @return	false if the job is invalid
+ */
+bool	read_job_definition(Definition_File& file, rpc::t_job& job, bool& found, v_definition_errors& errors);
+
+/**
+ * read_node_definition
+ *
+ * Same as read_job_definition for a node
+ */
+bool	read_node_definition(Definition_File& file, rpc::t_node& node, bool& found, v_definition_errors& errors);
+
+/**
+ * read_job_definitions
+ *
+ * Parses every job of the file. The key=value files are split at blank
+ * lines into parts of about DEFINITION_CHUNK_SIZE bytes, parsed by several
+ * threads. The JSON files are read by one thread.
+ *
+ * Each part is handed over in file order as soon as it is parsed, while the
+ * next ones are being parsed. At most threads parts are parsed ahead of the
+ * handler: the memory used does not depend on the size of the file.
+ *
+ * @param	file		the file to read
+ * @param	domain		the default domain of the jobs
+ * @param	threads		the maximum number of parsing threads
+ * @param	handler		called by the calling thread
+ * @param	chunk_size	the size of the parts, smaller ones are only useful to test the splitting
+ */
+void	read_job_definitions(const Definition_File& file, const std::string& domain, const size_t& threads, const job_definitions_handler& handler,
+	const size_t& chunk_size = DEFINITION_CHUNK_SIZE);
+
+/**
+ * read_job_definitions
+ *
+ * Same as above, the parts are merged into result
+ */
+void	read_job_definitions(const Definition_File& file, const std::string& domain, const size_t& threads, s_job_definitions& result,
+	const size_t& chunk_size = DEFINITION_CHUNK_SIZE);
+
+/**
+ * print_definition_errors
+ *
+ * Prints the errors, one per line, on stderr
+ */
+void	print_definition_errors(const v_definition_errors& errors);
+
+#endif // _DEFINITION_FILE_H_
@@ -0,0 +1,202 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: job_import.h
+ * Description: describes the bulk import of jobs
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _JOB_IMPORT_H_
+#define _JOB_IMPORT_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/bind/bind.hpp>
+#include <boost/thread.hpp>
+
+#include "connection_pool.h"
+#include "definition_file.h"
+
+/**
+ * The number of connections used by default
+ */
+#define IMPORT_CONNECTIONS	4
+
+/**
+ * The number of parsed jobs waiting to be sent, per connection
+ */
+#define IMPORT_QUEUE_SIZE	16
+
+/**
+ * The number of times a job is sent when its connection is lost
+ */
+#define IMPORT_ATTEMPTS	3
+
+/**
+ * @brief The s_import_summary struct
+ */
+struct s_import_summary {
+	size_t	added;		// accepted by the server
+	size_t	failed;		// refused by the server or lost by the connection
+	size_t	invalid;	// not sent: the block cannot be parsed
+};
+
+/**
+ * @brief The Job_Importer class
+ *
+ * Sends add_job requests over a pool of connections: each connection has its
+ * own thread, so several requests are in flight while the next parts of the
+ * file are being parsed.
+ */
+class Job_Importer {
+public:
+	/**
+	 * @brief Job_Importer
+	 * @param pool		the connections are borrowed from it
+	 * @param routing	the routing data of the requests, the jobs belong to
+	 *					its target domain by default
+	 */
+	Job_Importer(Connection_Pool& pool, const rpc::t_routing_data& routing);
+	~Job_Importer();
+
+	/**
+	 * @brief open
+	 *
+	 * Opens the connections and starts their threads
+	 *
+	 * @param hostname		the node to connect against
+	 * @param port
+	 * @param connections	the size of the pool
+	 *
+	 * @return false if no connection can be opened
+	 */
+	bool	open(const std::string& hostname, const int& port, const size_t& connections);
+
+	/**
+	 * @brief import
+	 *
+	 * Parses the job blocks of the file and sends each part as soon as it is
+	 * parsed, then waits for the answers. The invalid blocks are reported
+	 * with their line numbers and are not sent.
+	 *
+	 * @param input		the definitions (see read_job_definitions)
+	 * @param threads	the maximum number of parsing threads
+	 */
+	void	import(const Definition_File& input, const size_t& threads);
+
+	s_import_summary	summary();
+
+private:
+	/**
+	 * @brief push_definitions
+	 *
+	 * The job_definitions_handler of import: reports the errors and queues
+	 * the jobs of a part of the file
+	 */
+	void	push_definitions(s_job_definitions& definitions);
+
+	/**
+	 * @brief push
+	 *
+	 * Queues a job, waits while the queue is full
+	 */
+	void	push(rpc::t_job&& job);
+
+	/**
+	 * @brief finish
+	 *
+	 * Waits for the queued jobs and gives the connections back
+	 */
+	void	finish();
+
+	/**
+	 * @brief pop
+	 *
+	 * Takes the next job, waits while the queue is empty
+	 *
+	 * @return false when the queue is closed and empty
+	 */
+	bool	pop(rpc::t_job& job);
+
+	/**
+	 * @brief requeue
+	 *
+	 * Gives back a job which has not been sent, another connection sends it
+	 */
+	void	requeue(rpc::t_job& job);
+
+	/**
+	 * @brief count
+	 *
+	 * Adds the answer of a job to the summary
+	 */
+	void	count(const bool& added);
+
+	/**
+	 * @brief reconnect
+	 *
+	 * Replaces the broken connection of a thread by a new one
+	 *
+	 * @return false if no connection can be opened
+	 */
+	bool	reconnect(const size_t& slot);
+
+	/**
+	 * @brief leave
+	 *
+	 * Called by a thread which stops: when no thread is left, the queued
+	 * jobs are counted as failed
+	 */
+	void	leave();
+
+	/**
+	 * @brief send
+	 *
+	 * A connection's thread: sends the queued jobs until the queue is closed.
+	 * A lost connection is replaced, the thread stops if it cannot be.
+	 *
+	 * @param slot	the index of its connection
+	 */
+	void	send(const size_t& slot);
+
+	Connection_Pool&							_pool;
+	rpc::t_routing_data							_routing;
+	s_endpoint									_endpoint;
+	std::vector<std::unique_ptr<s_connection> >	_connections;
+	boost::thread_group							_senders;
+
+	boost::mutex								_mutex;
+	boost::condition_variable					_not_empty;
+	boost::condition_variable					_not_full;
+	std::deque<rpc::t_job>						_queue;
+	size_t										_queue_size;
+	bool										_closed;
+
+	// The threads still sending
+	size_t										_senders_left;
+
+	s_import_summary							_summary;
+};
+
+#endif // _JOB_IMPORT_H_
@@ -0,0 +1,79 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: job_list.h
+ * Description: describes the job lists kept by the cli
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _JOB_LIST_H_
+#define _JOB_LIST_H_
+
+#include <memory>
+
+#include "job_set.h"
+#include "job_query.h"
+
+/**
+ * @brief The Job_List class
+ *
+ * A fetched job list, printed as it was received. The first query interns
+ * it into a Job_Set with its own pool, and builds the set's index: the
+ * plain listings do not pay for them. The set and the index are freed with
+ * the list.
+ */
+class Job_List {
+public:
+	/**
+	 * @brief Job_List
+	 * @param jobs	the list to keep, it is emptied without copying
+	 */
+	Job_List(rpc::v_jobs& jobs);
+
+	// The set points to the pool
+	Job_List(const Job_List&) = delete;
+	Job_List&	operator=(const Job_List&) = delete;
+
+	const rpc::v_jobs&	jobs() const;
+
+	size_t	size() const;
+
+	/**
+	 * @brief select
+	 *
+	 * Copies the matching jobs, in the list's order. The first call builds
+	 * the set and its index, the list is used by one thread.
+	 *
+	 * @param query		the predicates, see Job_Index
+	 * @param matches	the result
+	 */
+	void	select(const s_job_query& query, rpc::v_jobs& matches) const;
+
+private:
+	rpc::v_jobs							_jobs;
+
+	String_Pool							_pool;
+	mutable Job_Set						_set;
+	mutable std::unique_ptr<Job_Index>	_index;
+};
+
+#endif // _JOB_LIST_H_
@@ -0,0 +1,163 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: job_query.h
+ * Description: describes the filters applied to the fetched jobs
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _JOB_QUERY_H_
+#define _JOB_QUERY_H_
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/foreach.hpp>
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+#include <boost/utility/string_view.hpp>
+
+#include "rpc_client.h"
+#include "job_set.h"
+#include "text_processing.h"
+
+/**
+ * @brief The s_name_pattern struct
+ *
+ * A name, or a prefix when it ends with '*'
+ */
+struct s_name_pattern {
+	std::string	text;
+	bool		prefix;
+};
+
+/**
+ * @brief The s_job_query struct
+ *
+ * The compiled predicates: a job matches when it matches one value of each
+ * non-empty list
+ */
+struct s_job_query {
+	std::vector<rpc::e_job_state::type>	states;
+	std::vector<s_name_pattern>			nodes;
+	std::vector<s_name_pattern>			names;
+
+	bool	empty() const {
+		return this->states.empty() == true && this->nodes.empty() == true && this->names.empty() == true;
+	}
+};
+
+/**
+ * is_query_key
+ *
+ * @return	true for state, node, node_name and name
+ */
+bool	is_query_key(const std::string& key);
+
+/**
+ * compile_predicate
+ *
+ * Adds a predicate to the query, the values are separated by ','
+ *
+ * @param	key		see is_query_key
+ * @param	value	state names, or names which can end with '*'
+ *
+ * @return	false if the value is not valid
+ */
+bool	compile_predicate(const std::string& key, const std::string& value, s_job_query& query);
+
+/**
+ * @brief The Job_Index class
+ *
+ * Indexes a job list by state, node name and name. Building the index costs
+ * a sort, then each query walks the matching ranges only: the index is kept
+ * by its Job_List, e.g. while the list is cached. The names are views of the
+ * set's pool.
+ */
+class Job_Index {
+public:
+	/**
+	 * @brief Job_Index
+	 * @param set	the jobs, they must outlive the index
+	 */
+	Job_Index(const Job_Set& set);
+
+	/**
+	 * @brief select
+	 *
+	 * Finds the matching jobs
+	 *
+	 * @param query		the predicates, every job matches an empty query
+	 * @param selected	their positions in the set, sorted
+	 */
+	void	select(const s_job_query& query, std::vector<size_t>& selected) const;
+
+private:
+	struct s_indexed_job {
+		rpc::e_job_state::type	state;
+		boost::string_view		node_name;
+		boost::string_view		name;
+
+		// In the list
+		size_t					position;
+	};
+
+	struct by_state {};
+	struct by_node {};
+	struct by_name {};
+
+	typedef boost::multi_index_container<
+		s_indexed_job,
+		boost::multi_index::indexed_by<
+			boost::multi_index::ordered_non_unique<boost::multi_index::tag<by_state>, boost::multi_index::member<s_indexed_job, rpc::e_job_state::type, &s_indexed_job::state> >,
+			boost::multi_index::ordered_non_unique<boost::multi_index::tag<by_node>, boost::multi_index::member<s_indexed_job, boost::string_view, &s_indexed_job::node_name> >,
+			boost::multi_index::ordered_non_unique<boost::multi_index::tag<by_name>, boost::multi_index::member<s_indexed_job, boost::string_view, &s_indexed_job::name> >
+		>
+	> t_job_index;
+
+	/**
+	 * @brief select_patterns
+	 *
+	 * Appends the positions of the jobs whose key matches one of the patterns
+	 */
+	template<typename Index>
+	static void	select_patterns(const Index& index, const std::vector<s_name_pattern>& patterns, std::vector<size_t>& positions);
+
+	/**
+	 * @brief restrict
+	 *
+	 * Keeps the positions found by both selections
+	 *
+	 * @param selected	sorted and unique positions, the first selection is
+	 *					taken as it is
+	 */
+	static void	restrict(std::vector<size_t>& selected, std::vector<size_t>& positions, bool& first);
+
+	const Job_Set&	_set;
+	t_job_index		_index;
+};
+
+#endif // _JOB_QUERY_H_
@@ -0,0 +1,157 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: job_set.h
+ * Description: describes the compact set of fetched jobs
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _JOB_SET_H_
+#define _JOB_SET_H_
+
+#include <vector>
+#include <stdint.h>
+#include <boost/foreach.hpp>
+
+#include "model_types.h"
+#include "string_pool.h"
+
+/**
+ * @brief The s_job_record struct
+ *
+ * A job whose strings are interned: the names are compared as integers.
+ * The links and the time constraints are ranges of the set's shared arrays.
+ */
+struct s_job_record {
+	string_id						name;
+	string_id						domain;
+	string_id						node_name;
+	string_id						cmd_line;
+	string_id						recovery_short_label;
+	string_id						recovery_label;
+	rpc::e_rectype_action::type		recovery_action;
+	rpc::e_job_state::type			state;
+
+	uint32_t						nxt;	// the first link in the set's links
+	uint32_t						nxt_count;
+	uint32_t						prv;
+	uint32_t						prv_count;
+	uint32_t						time_constraints;	// the first one in the set's time constraints
+	uint32_t						time_constraints_count;
+
+	rpc::integer					return_code;
+	rpc::integer					start_time;
+	rpc::integer					stop_time;
+	rpc::integer					weight;
+};
+
+/**
+ * @brief The s_time_constraint_record struct
+ */
+struct s_time_constraint_record {
+	rpc::e_time_constraint_type::type	type;
+	rpc::integer						value;
+};
+
+/**
+ * @brief The Job_Set class
+ *
+ * Keeps fetched jobs in a compact form: the strings are interned in a pool
+ * which can be shared by several sets, the links and the time constraints
+ * of all the jobs are stored in two arrays. The sets sharing a pool can be
+ * compared without comparing any string.
+ */
+class Job_Set {
+public:
+	/**
+	 * @brief Job_Set
+	 * @param pool	the strings' pool, it must outlive the set
+	 */
+	Job_Set(String_Pool& pool);
+
+	void	add(const rpc::t_job& job);
+	void	add(const rpc::v_jobs& jobs);
+
+	/**
+	 * @brief clear
+	 *
+	 * Drops the jobs, the pool keeps the strings
+	 */
+	void	clear();
+
+	size_t	size() const;
+
+	const s_job_record&	record(const size_t& i) const;
+
+	/**
+	 * @brief nxt
+	 * @return the first link of the record, there are nxt_count of them
+	 */
+	const string_id*	nxt(const s_job_record& job) const;
+	const string_id*	prv(const s_job_record& job) const;
+
+	const s_time_constraint_record*	time_constraints(const s_job_record& job) const;
+
+	/**
+	 * @brief get
+	 *
+	 * Rebuilds a job, for the printers and the RPC calls
+	 *
+	 * @param i		the job's index
+	 * @param job	the result
+	 */
+	void	get(const size_t& i, rpc::t_job& job) const;
+	void	get(rpc::v_jobs& jobs) const;
+
+	/**
+	 * @brief equals
+	 *
+	 * Compares two jobs of sets sharing the same pool
+	 *
+	 * @return true if every attribute is the same
+	 */
+	bool	equals(const s_job_record& job, const Job_Set& other, const s_job_record& other_job) const;
+
+	String_Pool&	pool() const;
+
+	/**
+	 * @brief memory
+	 * @return the approximate number of bytes used by the set, without the pool
+	 */
+	size_t	memory() const;
+
+private:
+	/**
+	 * @brief intern
+	 * @return the index of the first name stored in _links
+	 */
+	uint32_t	intern(const std::vector<std::string>& names);
+
+	void	names(const uint32_t& first, const uint32_t& count, std::vector<std::string>& result) const;
+
+	String_Pool*							_pool;
+	std::vector<s_job_record>				_jobs;
+	std::vector<string_id>					_links;
+	std::vector<s_time_constraint_record>	_time_constraints;
+};
+
+#endif // _JOB_SET_H_
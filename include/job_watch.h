@@ -0,0 +1,111 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: job_watch.h
+ * Description: describes the comparison of successive job lists
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _JOB_WATCH_H_
+#define _JOB_WATCH_H_
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <boost/foreach.hpp>
+
+#include "rpc_client.h"
+#include "job_set.h"
+
+/**
+ * The number of seconds between two polls by default
+ */
+#define WATCH_INTERVAL	5
+
+/**
+ * @brief The s_job_changes struct
+ *
+ * The differences between two job lists
+ */
+struct s_job_changes {
+	rpc::v_jobs	added;
+	rpc::v_jobs	changed;
+
+	// As they were last seen
+	rpc::v_jobs	removed;
+
+	bool	empty() const {
+		return this->added.empty() == true && this->changed.empty() == true && this->removed.empty() == true;
+	}
+};
+
+/**
+ * @brief The Job_Watch class
+ *
+ * Keeps the last job list in a Job_Set and compares the next ones with it.
+ * Both sets share the watch's pool: the jobs are matched by the id of their
+ * name, without comparing any string. A job has changed when its state, its
+ * return code, its start or its stop time is different.
+ *
+ * The pool keeps the strings seen since the watch started, until clear().
+ */
+class Job_Watch {
+public:
+	Job_Watch();
+
+	// The sets point to the pool
+	Job_Watch(const Job_Watch&) = delete;
+	Job_Watch&	operator=(const Job_Watch&) = delete;
+
+	/**
+	 * @brief update
+	 *
+	 * Compares the jobs with the previous list then keeps them. The first
+	 * list is reported as added.
+	 *
+	 * @param jobs		the new list, it is emptied
+	 * @param changes	the differences
+	 */
+	void	update(rpc::v_jobs& jobs, s_job_changes& changes);
+
+	/**
+	 * @brief clear
+	 *
+	 * Forgets the last list and the strings
+	 */
+	void	clear();
+
+	size_t	size() const;
+
+private:
+	String_Pool								_pool;
+	Job_Set									_previous;
+	Job_Set									_current;
+
+	// The position of the previous jobs by name
+	std::unordered_map<string_id, size_t>	_positions;
+
+	// The previous jobs found by the update
+	std::vector<bool>						_seen;
+};
+
+#endif // _JOB_WATCH_H_
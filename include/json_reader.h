@@ -0,0 +1,166 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: json_reader.h
+ * Description: describes the single-pass JSON reader
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _JSON_READER_H_
+#define _JSON_READER_H_
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <boost/utility/string_view.hpp>
+
+/**
+ * The deepest nesting of objects and arrays accepted
+ */
+#define JSON_MAX_DEPTH	64
+
+/**
+ * @brief The Json_Reader class
+ *
+ * Reads a JSON text in one pass, value by value: the caller asks for the
+ * values it expects and no tree is built. The strings without escapes are
+ * given as views of the text.
+ *
+ * Several top-level values can follow each other (NDJSON).
+ *
+ * Every method returns false on a syntax error, error() tells why and
+ * line_number() where.
+ */
+class Json_Reader {
+public:
+	/**
+	 * @brief Json_Reader
+	 * @param data			the text, it must outlive the reader
+	 * @param size
+	 * @param line_number	the number of the lines before the text
+	 */
+	Json_Reader(const char* data, const size_t& size, const size_t& line_number = 0);
+
+	/**
+	 * @brief peek
+	 *
+	 * Skips the blanks
+	 *
+	 * @return the first character of the next value, '\0' at the end
+	 */
+	char	peek();
+
+	bool	begin_object();
+
+	/**
+	 * @brief next_member
+	 *
+	 * Reads the next member's name and the colon, or the end of the object
+	 *
+	 * @param key	the name, valid until the next call
+	 * @param more	false at the end of the object
+	 */
+	bool	next_member(boost::string_view& key, bool& more);
+
+	bool	begin_array();
+
+	/**
+	 * @brief next_item
+	 *
+	 * Moves to the next item of the array, or reads its end
+	 *
+	 * @param more	false at the end of the array
+	 */
+	bool	next_item(bool& more);
+
+	/**
+	 * @brief read_string
+	 * @param value	a view of the text, or of a buffer of the reader when
+	 *				there are escapes: valid until the next string is read
+	 */
+	bool	read_string(boost::string_view& value);
+
+	/**
+	 * @brief read_string
+	 *
+	 * Same as above, the string is copied into value
+	 */
+	bool	read_string(std::string& value);
+
+	bool	read_integer(int64_t& value);
+
+	/**
+	 * @brief skip_value
+	 *
+	 * Reads the next value, whatever its type, and drops it
+	 */
+	bool	skip_value();
+
+	/**
+	 * @brief line_number
+	 * @return the line of the current position, starting at 1
+	 */
+	size_t	line_number() const;
+
+	/**
+	 * @brief error
+	 * @return the reason of the last syntax error
+	 */
+	const char*	error() const;
+
+private:
+	bool	fail(const char* message);
+
+	bool	expect(const char& c);
+
+	/**
+	 * @brief next
+	 *
+	 * Handles the comma before an item of the current container
+	 *
+	 * @param end	the character closing the container
+	 * @param more	false if the container is closed
+	 */
+	bool	next(const char& end, bool& more);
+
+	/**
+	 * @brief scan_string
+	 *
+	 * Reads a string, the escapes are decoded into buffer
+	 */
+	bool	scan_string(boost::string_view& value, std::string& buffer);
+
+	bool	skip_literal(const char* literal);
+
+	const char*			_position;
+	const char*			_end;
+	size_t				_line_number;
+	const char*			_error;
+
+	// One entry per opened container: true when no item has been read yet
+	std::vector<bool>	_first;
+
+	std::string			_key_buffer;
+	std::string			_value_buffer;
+};
+
+#endif // _JSON_READER_H_
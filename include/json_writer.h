@@ -0,0 +1,130 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: json_writer.h
+ * Description: describes the streaming JSON writer
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _JSON_WRITER_H_
+#define _JSON_WRITER_H_
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <boost/foreach.hpp>
+
+#include "output_buffer.h"
+
+/**
+ * @brief The Json_Writer class
+ *
+ * Writes a JSON document into an Output_Buffer while it is being built: no
+ * tree is kept in memory, only one flag per opened container to know if a
+ * comma is needed.
+ */
+class Json_Writer {
+public:
+	/**
+	 * @brief Json_Writer
+	 * @param buffer			the output
+	 * @param pretty			put each member on its own line
+	 * @param indent_character	the character used to indent (pretty mode)
+	 * @param depth				the initial indentation level
+	 */
+	Json_Writer(Output_Buffer& buffer, const bool& pretty, const char& indent_character, const size_t& depth = 0);
+
+	void	begin_object();
+	void	end_object();
+
+	void	begin_array();
+	void	end_array();
+
+	/**
+	 * @brief enter_array
+	 *
+	 * Continues an array opened by another writer: nothing is written, the
+	 * following values are separated as if they were written after the
+	 * previous ones.
+	 *
+	 * @param has_items	true when the array already has items
+	 */
+	void	enter_array(const bool& has_items);
+
+	/**
+	 * @brief leave_array
+	 *
+	 * Stops writing into the current array without closing it
+	 */
+	void	leave_array();
+
+	/**
+	 * @brief key
+	 *
+	 * Writes a member's name, the next call must write its value
+	 *
+	 * @param name
+	 */
+	void	key(const char* name);
+
+	void	value(const boost::string_view& v);
+	void	value(const char* v, const size_t& size);
+	void	value(const int64_t& v);
+
+	/**
+	 * @brief value
+	 *
+	 * Writes a list of strings as an array
+	 *
+	 * @param v
+	 */
+	void	value(const std::vector<std::string>& v);
+
+	void	member(const char* name, const boost::string_view& v);
+	void	member(const char* name, const int64_t& v);
+	void	member(const char* name, const std::vector<std::string>& v);
+
+private:
+	/**
+	 * @brief next_item
+	 *
+	 * Writes the comma and the indentation needed before a new item
+	 */
+	void	next_item();
+
+	void	new_line();
+
+	void	write_escaped(const char* v, const size_t& size);
+
+	Output_Buffer&		_buffer;
+	bool				_pretty;
+	std::string			_indent;
+	size_t				_depth;
+
+	// One entry per opened container: true when it already has an item
+	std::vector<bool>	_has_items;
+
+	// true when a key has been written and its value is expected
+	bool				_after_key;
+};
+
+#endif // _JSON_WRITER_H_
@@ -141,6 +141,7 @@ int cli_set_configmode(struct cli_def *cli, int mode, const char *config_desc);
 void cli_reprompt(struct cli_def *cli);
 void cli_regular(struct cli_def *cli, int (*callback)(struct cli_def *cli));
 void cli_regular_interval(struct cli_def *cli, int seconds);
+int cli_run_regular(struct cli_def *cli);
 //void cli_print(struct cli_def *cli, const char *format, ...) __attribute__((format (printf, 2, 3)));
 //void cli_print(const char *format, ...) __attribute__((format (printf, 1, 2)));
 void cli_bufprint(struct cli_def *cli, const char *format, ...) __attribute__((format (printf, 2, 3)));
@@ -0,0 +1,132 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: node_fan_out.h
+ * Description: describes the parallel requests sent to every node of a domain
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _NODE_FAN_OUT_H_
+#define _NODE_FAN_OUT_H_
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/foreach.hpp>
+#include <boost/bind/bind.hpp>
+#include <boost/thread.hpp>
+
+#include "connection_pool.h"
+
+/**
+ * The number of nodes requested at the same time by default
+ */
+#define FAN_OUT_WORKERS	16
+
+/**
+ * @brief The s_node_jobs struct
+ *
+ * The answer of a node
+ */
+struct s_node_jobs {
+	rpc::t_node	node;
+	rpc::v_jobs	jobs;
+
+	// The time spent to connect and to get the jobs
+	double		seconds;
+
+	// Empty on success
+	std::string	error;
+};
+
+typedef std::vector<s_node_jobs> v_node_jobs;
+
+/**
+ * @brief The Node_Fan_Out class
+ *
+ * Sends get_jobs to every node of a domain using a bounded pool of workers:
+ * each worker borrows a connection to a node, gets its jobs, gives the
+ * connection back and takes the next node. The whole walk takes about as long as the slowest
+ * nodes.
+ */
+class Node_Fan_Out {
+public:
+	/**
+	 * @brief Node_Fan_Out
+	 * @param pool		the connections are borrowed from it
+	 * @param routing	the routing data of the requests, the target node is
+	 *					replaced by each node
+	 * @param port		the nodes' port, the hostname is the node's name
+	 */
+	Node_Fan_Out(Connection_Pool& pool, const rpc::t_routing_data& routing, const int& port);
+
+	/**
+	 * @brief get_jobs
+	 *
+	 * Waits for every node's answer
+	 *
+	 * @param nodes		the nodes to request, given by get_nodes
+	 * @param workers	the maximum number of requests in flight
+	 * @param results	one entry per node, in the order of nodes
+	 */
+	void	get_jobs(const rpc::v_nodes& nodes, const size_t& workers, v_node_jobs& results);
+
+private:
+	/**
+	 * @brief work
+	 *
+	 * A worker's thread: requests the nodes until every one is taken
+	 */
+	void	work(v_node_jobs* results);
+
+	/**
+	 * @brief get_node_jobs
+	 *
+	 * Connects to the node and gets its jobs, the errors are kept in result
+	 */
+	void	get_node_jobs(s_node_jobs& result);
+
+	Connection_Pool&	_pool;
+	rpc::t_routing_data	_routing;
+	int					_port;
+
+	boost::mutex		_mutex;
+	size_t				_next;
+};
+
+/**
+ * @brief merge_node_jobs
+ *
+ * Appends the jobs of every node in the nodes' order. A job without node
+ * name gets the name of the node which sent it.
+ *
+ * @param results	the answers, their jobs are moved
+ * @param jobs		the merged list
+ *
+ * @return the number of nodes which failed
+ */
+size_t	merge_node_jobs(v_node_jobs& results, rpc::v_jobs& jobs);
+
+#endif // _NODE_FAN_OUT_H_
@@ -0,0 +1,130 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: output_buffer.h
+ * Description: describes the buffer used to stream large outputs
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _OUTPUT_BUFFER_H_
+#define _OUTPUT_BUFFER_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <boost/foreach.hpp>
+#include <boost/utility/string_view.hpp>
+
+/**
+ * The amount of bytes kept in memory before writing to the sink
+ */
+#define OUTPUT_BUFFER_FLUSH_SIZE	262144
+
+/**
+ * The size of the buffer needed to format any 64 bits integer
+ */
+#define OUTPUT_INTEGER_SIZE	24
+
+/**
+ * @brief The Output_Buffer class
+ *
+ * Accumulates the rendered text and writes it to the sink by blocks of
+ * OUTPUT_BUFFER_FLUSH_SIZE bytes. The remaining data is written when the
+ * object is destroyed.
+ *
+ * Without a sink, the buffer grows and keeps everything in memory until
+ * clear() is called.
+ */
+class Output_Buffer {
+public:
+	Output_Buffer(std::ostream& sink, const size_t& flush_size = OUTPUT_BUFFER_FLUSH_SIZE);
+	Output_Buffer(const size_t& initial_size = OUTPUT_BUFFER_FLUSH_SIZE);
+	~Output_Buffer();
+
+	/**
+	 * @brief append
+	 * @param data	the bytes to copy
+	 * @param size	the number of bytes
+	 */
+	void	append(const char* data, const size_t& size);
+	void	append(const boost::string_view& data);
+	void	append(const char& c);
+
+	/**
+	 * @brief append_integer
+	 *
+	 * Writes the decimal representation of the number without using a stream
+	 *
+	 * @param value
+	 */
+	void	append_integer(const int64_t& value);
+
+	/**
+	 * @brief flush
+	 *
+	 * Writes the pending bytes to the sink
+	 */
+	void	flush();
+
+	const char*	data() const;
+	size_t		size() const;
+
+	/**
+	 * @brief clear
+	 *
+	 * Drops the pending bytes without writing them
+	 */
+	void	clear();
+
+private:
+	std::ostream*		_sink;
+	std::vector<char>	_data;
+	size_t				_size;
+};
+
+/**
+ * @brief format_integer
+ *
+ * Writes the decimal representation of the number at the end of digits
+ *
+ * @param value		the number to format
+ * @param digits	the destination
+ *
+ * @return the first character, the last one is digits[OUTPUT_INTEGER_SIZE - 1]
+ */
+const char*	format_integer(const int64_t& value, char (&digits)[OUTPUT_INTEGER_SIZE]);
+
+/**
+ * @brief write_buffers
+ *
+ * Writes the content of the buffers, in order, to the file descriptor using
+ * as few system calls as possible
+ *
+ * @param fd		the file descriptor to write to
+ * @param buffers	the buffers to write
+ *
+ * @return true on success
+ */
+bool	write_buffers(const int& fd, const std::vector<const Output_Buffer*>& buffers);
+
+#endif // _OUTPUT_BUFFER_H_
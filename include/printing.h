@@ -26,19 +26,50 @@
  */
 
 #ifndef _PRINTING_H_
+#define _PRINTING_H_
+
 #include <iostream>
+#include <fstream>
 #include <algorithm>
+#include <cctype>
+#include <memory>
 #include <unordered_map>
+#include <unistd.h>
+#include <fcntl.h>
+#include <boost/bind/bind.hpp>
 #include <boost/foreach.hpp>
+#include <boost/thread.hpp>
 
 #include "convertions.h"
 #include "model_types.h"
 
 #include "text_processing.h"
+#include "output_buffer.h"
+#include "json_writer.h"
+#include "snapshot.h"
+
+/**
+ * The deepest indentation level rendered, deeper levels are truncated
+ */
+#define PRINTING_MAX_INDENT	32
+
+/**
+ * The maximum number of jobs or nodes rendered by a thread at once
+ */
+#define PRINTING_CHUNK_SIZE	4096
 
-typedef std::unordered_map<std::string, std::string> m_kv;
+/**
+ * The maximum number of columns of a table
+ */
+#define PRINTING_MAX_COLUMNS	16
 
-void	get_indent(const s_printing_options& opts, const uint& numbera, std::string& _return);
+#ifndef UNUSED
+#ifdef __GNUC__
+#define UNUSED(d) d __attribute__ ((unused))
+#else
+#define UNUSED(d) d
+#endif
+#endif
 
 void	print_kv(const s_printing_options& opts, const uint& indent, const m_kv& kv);
 
@@ -54,4 +85,344 @@ void	print_time_constraint(const s_printing_options& opts, const uint& indent, c
 void	print_resources(const s_printing_options& opts, const uint& indent, const rpc::v_resources& resources);
 void	print_resource(const s_printing_options& opts, const uint& indent, const rpc::t_resource& resource);
 
+/**
+ * @brief print_snapshot
+ *
+ * Prints the content of a loaded snapshot
+ */
+void	print_snapshot(const s_printing_options& opts, const uint& indent, const s_snapshot& snapshot);
+
+/*
+ * Formatters
+ *
+ * There is one formatter per output type. The print_* functions choose it
+ * once, according to the options, then the whole rendering is done by the
+ * formatter's write() overloads without checking the output type again.
+ * A formatter only uses its own state, several ones can work at the same time.
+ */
+
+/**
+ * @brief The Plain_Formatter class
+ *
+ * Renders human readable text, one attribute per line
+ */
+class Plain_Formatter {
+public:
+	Plain_Formatter(Output_Buffer& buffer, const s_printing_options& opts, const uint& depth);
+
+	void	write(const m_kv& kv);
+
+	void	write(const rpc::v_nodes& nodes);
+	void	write(const rpc::t_node& node);
+
+	void	write(const rpc::v_jobs& jobs);
+	void	write(const rpc::t_job& job);
+
+	void	write(const rpc::v_time_constraints& tcs);
+	void	write(const rpc::t_time_constraint& tc);
+
+	void	write(const rpc::v_resources& resources);
+	void	write(const rpc::t_resource& resource);
+
+	/*
+	 * The lists can also be rendered by parts: write(list) is the same as
+	 * write_head(list), write_items(list, 0, list.size()) then write_tail(list).
+	 * Several formatters can render different items of the same list at the
+	 * same time, each one into its own buffer.
+	 */
+	void	write_head(const rpc::v_nodes& nodes);
+	void	write_items(const rpc::v_nodes& nodes, const size_t& first, const size_t& last);
+	void	write_tail(const rpc::v_nodes& nodes);
+
+	void	write_head(const rpc::v_jobs& jobs);
+	void	write_items(const rpc::v_jobs& jobs, const size_t& first, const size_t& last);
+	void	write_tail(const rpc::v_jobs& jobs);
+
+	/**
+	 * @brief end
+	 *
+	 * Terminates the document
+	 */
+	void	end();
+
+private:
+	/**
+	 * @brief field
+	 *
+	 * Writes an indented "name:<tab>value" line
+	 */
+	void	field(const char* name, const size_t& size, const boost::string_view& value);
+	void	field(const char* name, const size_t& size, const int64_t& value);
+	void	field(const char* name, const size_t& size, const std::vector<std::string>& values);
+
+	void	indent();
+
+	Output_Buffer&				_buffer;
+	const s_printing_options&	_opts;
+	uint32_t					_fields;
+	uint						_depth;
+	char						_indents[PRINTING_MAX_INDENT];
+};
+
+/**
+ * @brief The Json_Formatter class
+ *
+ * Renders an indented JSON document
+ */
+class Json_Formatter {
+public:
+	Json_Formatter(Output_Buffer& buffer, const s_printing_options& opts, const uint& depth, const bool& pretty = true);
+
+	void	write(const m_kv& kv);
+
+	void	write(const rpc::v_nodes& nodes);
+	void	write(const rpc::t_node& node);
+
+	void	write(const rpc::v_jobs& jobs);
+	void	write(const rpc::t_job& job);
+
+	void	write(const rpc::v_time_constraints& tcs);
+	void	write(const rpc::t_time_constraint& tc);
+
+	void	write(const rpc::v_resources& resources);
+	void	write(const rpc::t_resource& resource);
+
+	void	write_head(const rpc::v_nodes& nodes);
+	void	write_items(const rpc::v_nodes& nodes, const size_t& first, const size_t& last);
+	void	write_tail(const rpc::v_nodes& nodes);
+
+	void	write_head(const rpc::v_jobs& jobs);
+	void	write_items(const rpc::v_jobs& jobs, const size_t& first, const size_t& last);
+	void	write_tail(const rpc::v_jobs& jobs);
+
+	void	end();
+
+protected:
+	Output_Buffer&				_buffer;
+	const s_printing_options&	_opts;
+	uint32_t					_fields;
+	Json_Writer					_writer;
+};
+
+/**
+ * @brief The Ndjson_Formatter class
+ *
+ * Renders one compact JSON record per line: the lists are not surrounded by
+ * an array, each of their items is a record.
+ */
+class Ndjson_Formatter : public Json_Formatter {
+public:
+	Ndjson_Formatter(Output_Buffer& buffer, const s_printing_options& opts, const uint& depth);
+
+	void	write(const m_kv& kv);
+
+	void	write(const rpc::v_nodes& nodes);
+	void	write(const rpc::t_node& node);
+
+	void	write(const rpc::v_jobs& jobs);
+	void	write(const rpc::t_job& job);
+
+	void	write(const rpc::v_time_constraints& tcs);
+	void	write(const rpc::t_time_constraint& tc);
+
+	void	write(const rpc::v_resources& resources);
+	void	write(const rpc::t_resource& resource);
+
+	void	write_head(const rpc::v_nodes& nodes);
+	void	write_items(const rpc::v_nodes& nodes, const size_t& first, const size_t& last);
+	void	write_tail(const rpc::v_nodes& nodes);
+
+	void	write_head(const rpc::v_jobs& jobs);
+	void	write_items(const rpc::v_jobs& jobs, const size_t& first, const size_t& last);
+	void	write_tail(const rpc::v_jobs& jobs);
+
+	void	end();
+};
+
+/**
+ * @brief The Table_Formatter class
+ *
+ * Renders the lists as tables, one row per item. The columns' widths are
+ * computed by a first pass over the list and the cells longer than
+ * opts.column_width are truncated. A node's jobs and resources are counted.
+ */
+class Table_Formatter {
+public:
+	Table_Formatter(Output_Buffer& buffer, const s_printing_options& opts, const uint& depth);
+
+	void	write(const m_kv& kv);
+
+	void	write(const rpc::v_nodes& nodes);
+	void	write(const rpc::t_node& node);
+
+	void	write(const rpc::v_jobs& jobs);
+	void	write(const rpc::t_job& job);
+
+	void	write(const rpc::v_time_constraints& tcs);
+	void	write(const rpc::t_time_constraint& tc);
+
+	void	write(const rpc::v_resources& resources);
+	void	write(const rpc::t_resource& resource);
+
+	void	end();
+
+private:
+	/**
+	 * @brief write_rows
+	 *
+	 * Renders the header and the rows of [first, last)
+	 *
+	 * @param columns	the columns to render (see Table_Row<T>::headers)
+	 * @param count		the number of columns
+	 */
+	template<typename Iterator>
+	void	write_rows(Iterator first, Iterator last, const size_t* columns, const size_t& count);
+
+	/**
+	 * @brief write_cell
+	 *
+	 * Writes the text, truncated to opts.column_width, padded to width unless
+	 * it is the last cell of the row
+	 */
+	template<typename Row>
+	void	write_cell(const Row& row, const size_t& column, const size_t& width, const bool& last);
+
+	/**
+	 * @brief pad
+	 *
+	 * Writes the spaces needed to reach the end of the cell and the columns'
+	 * separator
+	 */
+	void	pad(const size_t& written, const size_t& width);
+
+	Output_Buffer&				_buffer;
+	const s_printing_options&	_opts;
+	uint32_t					_fields;
+};
+
+/**
+ * @brief The Csv_Formatter class
+ *
+ * Renders the lists as comma separated values, one record per item after a
+ * header record. The values containing the separator, a quote or a new line
+ * are quoted (RFC 4180), cmd_line and the lists always are. The records are
+ * written while the list is walked: nothing else is kept in memory.
+ */
+class Csv_Formatter {
+public:
+	Csv_Formatter(Output_Buffer& buffer, const s_printing_options& opts, const uint& depth, const char& separator = ',');
+
+	void	write(const m_kv& kv);
+
+	void	write(const rpc::v_nodes& nodes);
+	void	write(const rpc::t_node& node);
+
+	void	write(const rpc::v_jobs& jobs);
+	void	write(const rpc::t_job& job);
+
+	void	write(const rpc::v_time_constraints& tcs);
+	void	write(const rpc::t_time_constraint& tc);
+
+	void	write(const rpc::v_resources& resources);
+	void	write(const rpc::t_resource& resource);
+
+	void	write_head(const rpc::v_nodes& nodes);
+	void	write_items(const rpc::v_nodes& nodes, const size_t& first, const size_t& last);
+	void	write_tail(const rpc::v_nodes& nodes);
+
+	void	write_head(const rpc::v_jobs& jobs);
+	void	write_items(const rpc::v_jobs& jobs, const size_t& first, const size_t& last);
+	void	write_tail(const rpc::v_jobs& jobs);
+
+	void	end();
+
+private:
+	/**
+	 * @brief write_header
+	 *
+	 * Writes the columns' names of the records of Row
+	 */
+	template<typename Row>
+	void	write_header(const size_t* columns, const size_t& count);
+
+	template<typename Row>
+	void	write_record(const Row& row, const size_t* columns, const size_t& count);
+
+	/**
+	 * @brief write_value
+	 *
+	 * Writes the text of the cell, quoted if needed
+	 */
+	template<typename Row>
+	void	write_value(const Row& row, const size_t& column);
+
+	Output_Buffer&				_buffer;
+	const s_printing_options&	_opts;
+	char						_separator;
+
+	// The jobs' columns, according to the fields
+	size_t						_job_columns[PRINTING_MAX_COLUMNS];
+	size_t						_job_columns_count;
+};
+
+/**
+ * @brief The Tsv_Formatter class
+ *
+ * Renders the lists as tab separated values
+ */
+class Tsv_Formatter : public Csv_Formatter {
+public:
+	Tsv_Formatter(Output_Buffer& buffer, const s_printing_options& opts, const uint& depth);
+};
+
+/**
+ * @brief The Binary_Formatter class
+ *
+ * Writes snapshots (see snapshot.h): the whole structures are written using
+ * Thrift's compact protocol, the fields' selection is ignored. A single item
+ * is written as a list of one item.
+ */
+class Binary_Formatter {
+public:
+	Binary_Formatter(Output_Buffer& buffer, const s_printing_options& opts, const uint& depth);
+
+	void	write(const m_kv& kv);
+
+	void	write(const rpc::v_nodes& nodes);
+	void	write(const rpc::t_node& node);
+
+	void	write(const rpc::v_jobs& jobs);
+	void	write(const rpc::t_job& job);
+
+	void	write(const rpc::v_time_constraints& tcs);
+	void	write(const rpc::t_time_constraint& tc);
+
+	void	write(const rpc::v_resources& resources);
+	void	write(const rpc::t_resource& resource);
+
+	void	write_head(const rpc::v_nodes& nodes);
+	void	write_items(const rpc::v_nodes& nodes, const size_t& first, const size_t& last);
+	void	write_tail(const rpc::v_nodes& nodes);
+
+	void	write_head(const rpc::v_jobs& jobs);
+	void	write_items(const rpc::v_jobs& jobs, const size_t& first, const size_t& last);
+	void	write_tail(const rpc::v_jobs& jobs);
+
+	void	end();
+
+private:
+	/**
+	 * @brief write_list
+	 *
+	 * Writes [first, last) as a whole snapshot
+	 */
+	template<typename T>
+	void	write_list(const e_snapshot_type& type, const T* first, const T* last);
+
+	Output_Buffer&								_buffer;
+	const s_printing_options&					_opts;
+	boost::shared_ptr<Output_Transport>			_transport;
+	apache::thrift::protocol::TCompactProtocol	_protocol;
+};
+
 #endif // _PRINTING_H_
@@ -0,0 +1,147 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: rpc_cache.h
+ * Description: describes the cache of the read requests
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _RPC_CACHE_H_
+#define _RPC_CACHE_H_
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rpc_client.h"
+#include "job_list.h"
+
+/**
+ * The number of seconds an answer is kept by default
+ */
+#define CACHE_TTL	5
+
+/**
+ * The node and the domain of a request
+ */
+typedef std::pair<std::string, std::string> cache_key;
+
+/**
+ * @brief The Rpc_Cache class
+ *
+ * Keeps the answers of get_nodes, get_jobs and get_available_planning_names
+ * for each (node, domain) during the TTL. The answers are shared: a hit does
+ * not copy them. The job lists are kept as Job_Lists, which are interned by
+ * their first query only. The commands changing a domain invalidate their
+ * answers, the whole cache is cleared when the server changes (connect,
+ * close).
+ *
+ * It is used by the cli's thread only.
+ */
+class Rpc_Cache {
+public:
+	/**
+	 * @brief Rpc_Cache
+	 * @param ttl	the number of seconds an answer is kept
+	 */
+	Rpc_Cache(const size_t& ttl = CACHE_TTL);
+
+	/**
+	 * @brief find_nodes
+	 * @return the cached answer, NULL if it is missing or expired
+	 */
+	std::shared_ptr<const rpc::v_nodes>	find_nodes(const rpc::t_routing_data& routing);
+
+	/**
+	 * @brief store_nodes
+	 *
+	 * Keeps an answer, the content of nodes is taken
+	 *
+	 * @return the stored answer, to be used instead of nodes
+	 */
+	std::shared_ptr<const rpc::v_nodes>	store_nodes(const rpc::t_routing_data& routing, rpc::v_nodes& nodes);
+
+	std::shared_ptr<const Job_List>	find_jobs(const rpc::t_routing_data& routing);
+	std::shared_ptr<const Job_List>	store_jobs(const rpc::t_routing_data& routing, rpc::v_jobs& jobs);
+
+	std::shared_ptr<const std::vector<std::string> >	find_planning_names(const rpc::t_routing_data& routing);
+	std::shared_ptr<const std::vector<std::string> >	store_planning_names(const rpc::t_routing_data& routing, std::vector<std::string>& names);
+
+	/**
+	 * @brief invalidate
+	 *
+	 * Drops the answers of every node for the domain
+	 */
+	void	invalidate(const std::string& domain);
+
+	void	clear();
+
+	/**
+	 * @brief set_enabled
+	 *
+	 * A disabled cache keeps nothing
+	 */
+	void	set_enabled(const bool& enabled);
+	void	set_ttl(const size_t& seconds);
+
+	size_t	hits() const;
+	size_t	misses() const;
+
+private:
+	template<typename T>
+	struct s_cache_entry {
+		std::shared_ptr<const T>				value;
+		std::chrono::steady_clock::time_point	stored;
+	};
+
+	template<typename T>
+	std::shared_ptr<const T>	find(std::map<cache_key, s_cache_entry<T> >& entries, const rpc::t_routing_data& routing);
+
+	template<typename T>
+	std::shared_ptr<const T>	store(std::map<cache_key, s_cache_entry<T> >& entries, const rpc::t_routing_data& routing, T& value);
+
+	/**
+	 * @brief keep
+	 *
+	 * Stores an answer if the cache is enabled
+	 */
+	template<typename T>
+	void	keep(std::map<cache_key, s_cache_entry<T> >& entries, const rpc::t_routing_data& routing, const std::shared_ptr<const T>& value);
+
+	template<typename T>
+	static void	invalidate(std::map<cache_key, s_cache_entry<T> >& entries, const std::string& domain);
+
+	bool									_enabled;
+	std::chrono::steady_clock::duration		_ttl;
+
+	std::map<cache_key, s_cache_entry<rpc::v_nodes> >				_nodes;
+	std::map<cache_key, s_cache_entry<Job_List> >					_jobs;
+	std::map<cache_key, s_cache_entry<std::vector<std::string> > >	_planning_names;
+
+	size_t									_hits;
+	size_t									_misses;
+};
+
+#endif // _RPC_CACHE_H_
@@ -0,0 +1,146 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: snapshot.h
+ * Description: describes the binary snapshots of jobs and nodes
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _SNAPSHOT_H_
+#define _SNAPSHOT_H_
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+
+#include <thrift/Thrift.h>
+#include <thrift/protocol/TCompactProtocol.h>
+#include <thrift/transport/TBufferTransports.h>
+#include <thrift/transport/TFDTransport.h>
+
+#include "model_types.h"
+
+#include "text_processing.h"
+#include "output_buffer.h"
+
+/*
+ * Snapshots
+ *
+ * The binary output type writes the fetched data as snapshots that can be
+ * loaded back by another invocation without asking the server again.
+ *
+ * A snapshot is:
+ *
+ *	offset	size	content
+ *	0		4		"OWSB"
+ *	4		1		the layout's version: SNAPSHOT_VERSION
+ *	5		1		the content's type (e_snapshot_type)
+ *	6		...		the content, using Thrift's compact protocol:
+ *					list<t_node>, list<t_job>, list<t_time_constraint>,
+ *					list<t_resource> or map<string,string>
+ *
+ * The content can be read by any Thrift implementation once the six bytes
+ * of the header are skipped. Several snapshots can be concatenated in the
+ * same file.
+ */
+
+#define SNAPSHOT_MAGIC			"OWSB"
+#define SNAPSHOT_MAGIC_SIZE		4
+#define SNAPSHOT_HEADER_SIZE	6
+#define SNAPSHOT_VERSION		1
+
+enum e_snapshot_type {
+	SNAPSHOT_NODES				= 'N',
+	SNAPSHOT_JOBS				= 'J',
+	SNAPSHOT_TIME_CONSTRAINTS	= 'T',
+	SNAPSHOT_RESOURCES			= 'R',
+	SNAPSHOT_KV					= 'K'
+};
+
+/**
+ * @brief The s_snapshot struct
+ *
+ * A loaded snapshot: only the member matching the type is filled
+ */
+struct s_snapshot {
+	e_snapshot_type				type;
+	rpc::v_nodes				nodes;
+	rpc::v_jobs					jobs;
+	rpc::v_time_constraints		time_constraints;
+	rpc::v_resources			resources;
+	m_kv						kv;
+};
+
+/**
+ * @brief The Output_Transport class
+ *
+ * Lets Thrift's protocols write into an Output_Buffer
+ */
+class Output_Transport : public apache::thrift::transport::TVirtualTransport<Output_Transport> {
+public:
+	Output_Transport(Output_Buffer& buffer);
+
+	uint32_t	read(uint8_t* buf, uint32_t len);
+	void		write(const uint8_t* buf, uint32_t len);
+
+private:
+	Output_Buffer&	_buffer;
+};
+
+/**
+ * @brief write_snapshot_header
+ * @param buffer	the output
+ * @param type		the content's type
+ */
+void	write_snapshot_header(Output_Buffer& buffer, const e_snapshot_type& type);
+
+/**
+ * @brief The Snapshot_Reader class
+ *
+ * Reads the snapshots from a file descriptor, one after the other
+ */
+class Snapshot_Reader {
+public:
+	Snapshot_Reader(const int& fd);
+
+	/**
+	 * @brief read
+	 *
+	 * Loads the next snapshot
+	 *
+	 * @param snapshot	the destination
+	 * @param end		set to true when there is nothing left to read
+	 *
+	 * @return false on error
+	 */
+	bool	read(s_snapshot& snapshot, bool& end);
+
+private:
+	template<typename T>
+	void	read_list(std::vector<T>& list);
+
+	void	read_kv(m_kv& kv);
+
+	boost::shared_ptr<apache::thrift::transport::TBufferedTransport>	_transport;
+	apache::thrift::protocol::TCompactProtocol							_protocol;
+};
+
+#endif // _SNAPSHOT_H_
@@ -0,0 +1,147 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: string_pool.h
+ * Description: describes the pool of interned strings
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#ifndef _STRING_POOL_H_
+#define _STRING_POOL_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <boost/utility/string_view.hpp>
+
+/**
+ * The size of the arena's blocks
+ */
+#define STRING_POOL_BLOCK_SIZE	65536
+
+/**
+ * The initial number of slots of the pool's hash table, a power of 2
+ */
+#define STRING_POOL_TABLE_SIZE	1024
+
+/**
+ * The identifier of an interned string, only valid within its pool
+ */
+typedef uint32_t	string_id;
+
+/**
+ * The empty slots of the pool's hash table
+ */
+#define STRING_POOL_NO_ID	UINT32_MAX
+
+/**
+ * @brief The String_Pool class
+ *
+ * Stores each distinct string once in an arena and gives it a small integer
+ * identifier: two strings of the same pool are equal if their identifiers
+ * are. The strings are kept until the pool is destroyed or cleared.
+ *
+ * The pool is not thread-safe.
+ */
+class String_Pool {
+public:
+	String_Pool();
+
+	/**
+	 * @brief intern
+	 * @param s	the string to store
+	 * @return the identifier of s, the same one for equal strings
+	 */
+	string_id	intern(const boost::string_view& s);
+
+	/**
+	 * @brief find
+	 *
+	 * Looks for a string without storing it
+	 *
+	 * @param s		the string to look for
+	 * @param id	its identifier
+	 * @return false if the string is not in the pool
+	 */
+	bool	find(const boost::string_view& s, string_id& id) const;
+
+	/**
+	 * @brief get
+	 * @param id	an identifier given by this pool
+	 * @return the string, valid while the pool is not cleared
+	 */
+	boost::string_view	get(const string_id& id) const;
+
+	/**
+	 * @brief size
+	 * @return the number of distinct strings
+	 */
+	size_t	size() const;
+
+	/**
+	 * @brief memory
+	 * @return the approximate number of bytes used by the pool
+	 */
+	size_t	memory() const;
+
+	void	clear();
+
+private:
+	/**
+	 * @brief hash
+	 * @return the FNV-1a hash of s
+	 */
+	static uint32_t	hash(const boost::string_view& s);
+
+	/**
+	 * @brief slot
+	 * @return the slot of the table holding s, or the empty one where it
+	 *			would be inserted
+	 */
+	size_t	slot(const boost::string_view& s) const;
+
+	/**
+	 * @brief grow
+	 *
+	 * Doubles the table, the strings are inserted again
+	 */
+	void	grow();
+
+	/**
+	 * @brief store
+	 * @return a copy of s in the arena
+	 */
+	boost::string_view	store(const boost::string_view& s);
+
+	std::vector<std::unique_ptr<char[]> >	_blocks;
+	char*									_block;			// the block receiving the short strings
+	size_t									_block_used;
+	size_t									_arena_size;
+
+	std::vector<boost::string_view>			_strings;		// indexed by identifier
+
+	// Open addressing, linear probing: the slots hold identifiers
+	std::vector<string_id>					_table;
+};
+
+#endif // _STRING_POOL_H_
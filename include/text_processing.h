@@ -25,9 +25,15 @@
  * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
  */
 
+#ifndef _TEXT_PROCESSING_H_
+#define _TEXT_PROCESSING_H_
+
+#include <ctime>
 #include <iostream>
 #include <string>
-#include <boost/regex.hpp>
+#include <unordered_map>
+#include <stdint.h>
+#include <boost/utility/string_view.hpp>
 #include <boost/foreach.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
@@ -40,32 +46,109 @@
 /**
  * @brief The e_output_type enum
  *
- * Used to print result in JSON or plain text.
+ * Used to print result in JSON, newline-delimited JSON (one record per line),
+ * plain text, aligned columns, comma/tab separated values or binary snapshots.
  */
 enum e_output_type {
 	json,
-	plain
+	ndjson,
+	plain,
+	table,
+	csv,
+	tsv,
+	binary
+};
+
+/**
+ * @brief The e_job_field enum
+ *
+ * The job's attributes which can be selected to be printed
+ */
+enum e_job_field {
+	JOB_FIELD_NAME				= 1 << 0,
+	JOB_FIELD_STATE				= 1 << 1,
+	JOB_FIELD_CMD_LINE			= 1 << 2,
+	JOB_FIELD_NODE_NAME			= 1 << 3,
+	JOB_FIELD_NXT				= 1 << 4,
+	JOB_FIELD_PRV				= 1 << 5,
+	JOB_FIELD_RECOVERY_TYPE		= 1 << 6,
+	JOB_FIELD_RETURN_CODE		= 1 << 7,
+	JOB_FIELD_START_TIME		= 1 << 8,
+	JOB_FIELD_STOP_TIME			= 1 << 9,
+	JOB_FIELD_TIME_CONSTRAINTS	= 1 << 10,
+	JOB_FIELD_WEIGHT			= 1 << 11
 };
 
+#define JOB_FIELDS_ALL		0x0fff
+#define JOB_FIELDS_PLAIN	(JOB_FIELD_NAME | JOB_FIELD_STATE | JOB_FIELD_CMD_LINE)
+
 struct s_printing_options {
 	bool			verbose	= false;
 	e_output_type	output_type = plain;
 	char			indent_character = '	';
+	size_t			render_threads = 1;
+	uint32_t		job_fields = 0; // e_job_field mask, 0: the output type's default
+	size_t			column_width = 48; // table output: the longest cell
+	std::string		output_file; // empty: stdout
+	bool			output_append = false; // output_file is not truncated
 };
 
+typedef std::unordered_map<std::string, std::string> m_kv;
+
+/**
+ * @brief job_state_to_string
+ *
+ * The names come from a static table: nothing is allocated
+ *
+ * @param state
+ * @return the state's name, empty if it is unknown
+ */
+boost::string_view	job_state_to_string(const rpc::e_job_state::type& state);
+
+/**
+ * @brief job_state_from_string
+ * @param name	the state's name, the case is ignored
+ * @param state	the result
+ * @return false if the name is unknown
+ */
+bool	job_state_from_string(const boost::string_view& name, rpc::e_job_state::type& state);
+
+/**
+ * @brief rectype_action_to_string
+ * @param action
+ * @return the action's name, empty if it is unknown
+ */
+boost::string_view	rectype_action_to_string(const rpc::e_rectype_action::type& action);
+
+/**
+ * @brief rectype_action_from_string
+ * @param name		the action's name (restart, stop or stop_schedule)
+ * @param action	the result
+ * @return false if the name is unknown
+ */
+bool	rectype_action_from_string(const boost::string_view& name, rpc::e_rectype_action::type& action);
+
 /**
  * @brief recovery_type_to_string
  * @param t
  * @return the type as string
  */
-std::string	recovery_type_action_to_string(const rpc::t_recovery_type& t);
+boost::string_view	recovery_type_action_to_string(const rpc::t_recovery_type& t);
 
 /**
  * @brief time_constraint_type_to_string
  * @param t
  * @return the enum type as a string
  */
-std::string	time_constraint_type_to_string(const rpc::e_time_constraint_type::type& t);
+boost::string_view	time_constraint_type_to_string(const rpc::e_time_constraint_type::type& t);
+
+/**
+ * @brief time_constraint_type_from_string
+ * @param name	the type's name (at, before or after)
+ * @param type	the result
+ * @return false if the name is unknown
+ */
+bool	time_constraint_type_from_string(const boost::string_view& name, rpc::e_time_constraint_type::type& type);
 
 /**
  * @brief time_constraint_to_string
@@ -88,6 +171,122 @@ std::string	strings_to_string(const std::vector<std::string>& v);
  */
 std::string	bool_to_string(const bool& v);
 
+/**
+ * @brief build_job_fields_from_string
+ *
+ * Builds the e_job_field mask from a list of attributes' names
+ *
+ * @param	list	a comma-separated list such as "name,state" ("all" selects every field)
+ * @param	fields	the resulting mask
+ *
+ * @return	true on success, false if a name is unknown
+ */
+bool	build_job_fields_from_string(const std::string& list, uint32_t& fields);
+
+/**
+ * @brief build_output_type_from_string
+ * @param	name	plain, json, ndjson, table, csv, tsv or binary
+ * @param	type	the resulting type
+ * @return	true on success, false if the name is unknown
+ */
+bool	build_output_type_from_string(const std::string& name, e_output_type& type);
+
+/**
+ * @brief output_type_to_string
+ * @param	type
+ * @return	the type's name
+ */
+const char*	output_type_to_string(const e_output_type& type);
+
+/**
+ * The number of hh:mm values
+ */
+#define HHMM_MINUTES_PER_DAY	1440
+
+/**
+ * parse_hhmm
+ *
+ * Parses a time of the day without allocating
+ *
+ * @param	text	hhmm or hh:mm, from 00:00 to 23:59
+ * @param	minutes	the number of minutes since midnight
+ *
+ * @return	false if the text is not a valid time
+ */
+bool	parse_hhmm(const boost::string_view& text, int& minutes);
+
+/**
+ * resolve_hhmm
+ *
+ * @param	minutes	the number of minutes since midnight
+ * @return	the unix time given by build_unix_time_from_hhmm_time
+ */
+time_t	resolve_hhmm(const int& minutes);
+
+/**
+ * @brief The Hhmm_Cache class
+ *
+ * Remembers the unix times of the hh:mm values resolved during an import:
+ * the same few values are shared by many jobs. It is not thread-safe, each
+ * parsing thread has its own.
+ */
+class Hhmm_Cache {
+public:
+	Hhmm_Cache();
+
+	/**
+	 * @brief resolve
+	 * @param minutes	the number of minutes since midnight, see parse_hhmm
+	 * @return	the unix time
+	 */
+	time_t	resolve(const int& minutes);
+
+private:
+	time_t	_times[HHMM_MINUTES_PER_DAY];
+	bool	_resolved[HHMM_MINUTES_PER_DAY];
+};
+
+/**
+ * The attributes known by update_node and update_job, the last ones can
+ * only be given in JSON documents
+ */
+enum e_attribute {
+	ATTRIBUTE_UNKNOWN,
+	ATTRIBUTE_NAME,
+	ATTRIBUTE_WEIGHT,
+	ATTRIBUTE_DOMAIN_NAME,
+	ATTRIBUTE_RESOURCES,
+	ATTRIBUTE_JOBS,
+	ATTRIBUTE_CMD_LINE,
+	ATTRIBUTE_NODE_NAME,
+	ATTRIBUTE_NXT,
+	ATTRIBUTE_PRV,
+	ATTRIBUTE_RECOVERY_TYPE,
+	ATTRIBUTE_TIME_CONSTRAINTS,
+	ATTRIBUTE_DOMAIN,
+	ATTRIBUTE_STATE,
+	ATTRIBUTE_RETURN_CODE,
+	ATTRIBUTE_START_TIME,
+	ATTRIBUTE_STOP_TIME,
+	ATTRIBUTE_SHORT_LABEL,
+	ATTRIBUTE_LABEL,
+	ATTRIBUTE_ACTION,
+	ATTRIBUTE_TYPE,
+	ATTRIBUTE_VALUE,
+	ATTRIBUTE_CURRENT_VALUE,
+	ATTRIBUTE_INITIAL_VALUE
+};
+
+/**
+ * find_attribute
+ *
+ * Finds the attribute with one switch and at most one comparison
+ *
+ * @param	key	the attribute's name
+ * @return	the attribute or ATTRIBUTE_UNKNOWN
+ */
+e_attribute	find_attribute(const boost::string_view& key);
+
 /**
  * update_node
  *
@@ -96,34 +295,71 @@ std::string	bool_to_string(const bool& v);
  * @param	key	the key to update
  * @param	value	the value to record
  * @param	node	the node to update
+ *
+ * @return	false if the key is not a node attribute
  */
-void	update_node(const std::string& key, const std::string& value, rpc::t_node& node);
+bool	update_node(const std::string& key, const std::string& value, rpc::t_node& node);
 
 /**
  * update_job
  *
  * Update the job's attribute according to the given key + value couple
  *
- * time_constraint pattern: time_constraint=(AFTER|AT|BEFORE):hhmm((,|;)(AFTER|AT|BEFORE):hhmm)*
+ * time_constraint pattern: time_constraint=(AFTER|AT|BEFORE):hh[:]mm((,|;)(AFTER|AT|BEFORE):hh[:]mm)*
  * hh: hours (2 digits)
  * mm: minutes (2 digits)
  *
+ * An invalid value throws std::invalid_argument or boost::bad_lexical_cast
+ *
  * @param	key	the key to update
  * @param	value	the value to record
  * @param	job	the job to update
+ * @param	cache	the resolved times of the import, NULL to resolve every time
+ *
+ * @return	false if the key is not a job attribute
  */
-void	update_job(const std::string& key, const std::string& value, rpc::t_job& job);
+bool	update_job(const std::string& key, const std::string& value, rpc::t_job& job, Hhmm_Cache* cache = NULL);
 
 /**
  * split_line
  *
- * Split a 'key=value' line
+ * Split a 'key=value' line in one pass, without copying: the key and the
+ * value point into data. The blanks around them are ignored, a '#' at the
+ * beginning of the line or after a blank starts a comment.
  *
  * @param	separator	the token to use to split
  * @param	data	the line to split
- * @param	key	the returned key
+ * @param	key	the returned key, empty if the line is blank or a comment
  * @param	value	the returned value
  *
  * @return	true on success
  */
+bool	split_line(const char& separator, const boost::string_view& data, boost::string_view& key, boost::string_view& value);
+
+/**
+ * split_line
+ *
+ * Same as above, the error is returned instead of being printed
+ *
+ * @param	error	the reason of the failure, a static string
+ */
+bool	split_line(const char& separator, const boost::string_view& data, boost::string_view& key, boost::string_view& value, const char*& error);
+
+/**
+ * split_line
+ *
+ * Same as above, the key and the value are copied
+ */
 bool	split_line(const char& separator, const std::string& data, std::string& key, std::string& value);
+
+/**
+ * trim
+ *
+ * @param	begin	the first character
+ * @param	end		the end of the text
+ *
+ * @return	the text without the blanks around it
+ */
+boost::string_view	trim(const char* begin, const char* end);
+
+#endif // _TEXT_PROCESSING_H_
@@ -0,0 +1,72 @@
+# Project: ows-cli
+# File name: ows-bench.pro
+# Description: describes the project and how to build it
+#
+# @author Mathieu Grzybek on 2013-06-11
+# @copyright 2013 Mathieu Grzybek. All rights reserved.
+# @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+#
+# @see The GNU Public License (GPL) version 3 or higher
+#
+#
+# ows-cli is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+# or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+# for more details.
+#
+# You should have received a copy of the GNU General Public License along
+# with this program; if not, write to the Free Software Foundation, Inc.,
+# 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+#
+
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= qt
+
+QMAKE_CXX_FLAGS	+= -O2
+QMAKE_C_FLAGS	+= -O2
+
+include(qmake_conf/linux.pro)
+include(qmake_conf/macx.pro)
+include(qmake_conf/bsd.pro)
+#include(qmake_conf/windows.pro)
+
+INCLUDEPATH	+= include \
+	../open-workload-scheduler/include \
+	../open-workload-scheduler/src/gen-cpp
+
+SOURCES		+= src/bench.cpp \
+	src/printing.cpp \
+	src/text_processing.cpp \
+	src/output_buffer.cpp \
+	src/json_writer.cpp \
+	src/allocation_counter.cpp \
+	src/snapshot.cpp \
+	src/string_pool.cpp \
+	src/job_set.cpp \
+	src/definition_file.cpp \
+	src/json_reader.cpp \
+	../open-workload-scheduler/src/gen-cpp/model_types.cpp \
+	../open-workload-scheduler/src/gen-cpp/model_constants.cpp \
+	../open-workload-scheduler/src/convertions.cpp
+
+HEADERS		+= include/bench.h \
+	include/printing.h \
+	include/text_processing.h \
+	include/output_buffer.h \
+	include/json_writer.h \
+	include/allocation_counter.h \
+	include/snapshot.h \
+	include/string_pool.h \
+	include/job_set.h \
+	include/definition_file.h \
+	include/json_reader.h \
+	../open-workload-scheduler/src/gen-cpp/model_types.h \
+	../open-workload-scheduler/src/gen-cpp/model_constants.h \
+	../open-workload-scheduler/include/convertions.h
@@ -44,6 +44,21 @@ INCLUDEPATH	+= include \
 SOURCES		+= src/cli.cpp \
 	src/printing.cpp \
 	src/text_processing.cpp \
+	src/output_buffer.cpp \
+	src/json_writer.cpp \
+	src/json_reader.cpp \
+	src/allocation_counter.cpp \
+	src/snapshot.cpp \
+	src/string_pool.cpp \
+	src/job_set.cpp \
+	src/job_list.cpp \
+	src/definition_file.cpp \
+	src/job_import.cpp \
+	src/node_fan_out.cpp \
+	src/connection_pool.cpp \
+	src/rpc_cache.cpp \
+	src/job_watch.cpp \
+	src/job_query.cpp \
 	src/libcli.c \
 	../open-workload-scheduler/src/gen-cpp/ows_rpc.cpp \
 	../open-workload-scheduler/src/gen-cpp/model_types.cpp \
@@ -54,6 +69,21 @@ SOURCES		+= src/cli.cpp \
 HEADERS		+= include/cli.h \
 	include/printing.h \
 	include/text_processing.h \
+	include/output_buffer.h \
+	include/json_writer.h \
+	include/json_reader.h \
+	include/allocation_counter.h \
+	include/snapshot.h \
+	include/string_pool.h \
+	include/job_set.h \
+	include/job_list.h \
+	include/definition_file.h \
+	include/job_import.h \
+	include/node_fan_out.h \
+	include/connection_pool.h \
+	include/rpc_cache.h \
+	include/job_watch.h \
+	include/job_query.h \
 	include/libcli.h \
 	../open-workload-scheduler/src/gen-cpp/ows_rpc.h \
 	../open-workload-scheduler/src/gen-cpp/model_types.h \
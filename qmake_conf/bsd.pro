@@ -33,6 +33,7 @@
 		/usr/local/lib/libboost_regex.a \
 		/usr/local/lib/libboost_filesystem.a \
 		/usr/local/lib/libboost_program_options.a \
+		/usr/local/lib/libboost_thread.a \
 		/usr/local/lib/libboost_system.a \
 		/usr/local/lib/liblog4cpp.a \
 		-lssl \
@@ -32,6 +32,7 @@ linux {
 		/usr/lib/libboost_regex.a \
 		/usr/lib/libboost_filesystem.a \
 		/usr/lib/libboost_program_options.a \
+		/usr/lib/libboost_thread.a \
 		/usr/lib/libboost_system.a \
 		/usr/lib/liblog4cpp.a \
 		-lssl \
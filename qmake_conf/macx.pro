@@ -33,6 +33,7 @@ macx {
 		-L/usr/local/lib \
 		/opt/local/lib/libboost_regex-mt.a \
 		/opt/local/lib/libboost_program_options-mt.a \
+		/opt/local/lib/libboost_thread-mt.a \
 		/opt/local/lib/libboost_system-mt.a \
 		/opt/local/lib/liblog4cpp.a \
 		-lssl \
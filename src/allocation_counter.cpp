@@ -0,0 +1,62 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: allocation_counter.cpp
+ * Description: implements the heap allocation counter used to profile the rendering
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "allocation_counter.h"
+
+static std::atomic<size_t>	allocation_count(0);
+
+size_t	get_allocation_count() {
+	return allocation_count.load(std::memory_order_relaxed);
+}
+
+void*	operator new(size_t size) {
+	void*	p = NULL;
+
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+
+	p = malloc(size == 0 ? 1 : size);
+	if ( p == NULL )
+		throw std::bad_alloc();
+
+	return p;
+}
+
+void*	operator new[](size_t size) {
+	return operator new(size);
+}
+
+void	operator delete(void* p) noexcept {
+	free(p);
+}
+
+void	operator delete[](void* p) noexcept {
+	free(p);
+}
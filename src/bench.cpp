@@ -0,0 +1,1669 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: bench.cpp
+ * Description: measures the rendering of synthetic plannings
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "bench.h"
+
+///////////////////////////////////////////////////////////////////////////////
+//	entry points
+///////////////////////////////////////////////////////////////////////////////
+
+void	bench_print_kv(const s_printing_options& opts, const s_planning& planning) {
+	// One hello per node
+	for ( size_t n = 0 ; n < planning.nodes.size() ; ++n ) {
+		print_kv(opts, 0, planning.kv);
+	}
+}
+
+void	bench_print_nodes(const s_printing_options& opts, const s_planning& planning) {
+	print_nodes(opts, 0, planning.nodes);
+}
+
+void	bench_print_node(const s_printing_options& opts, const s_planning& planning) {
+	BOOST_FOREACH(const rpc::t_node& node, planning.nodes) {
+		print_node(opts, 0, node);
+	}
+}
+
+void	bench_print_jobs(const s_printing_options& opts, const s_planning& planning) {
+	print_jobs(opts, 0, planning.jobs);
+}
+
+void	bench_print_job(const s_printing_options& opts, const s_planning& planning) {
+	BOOST_FOREACH(const rpc::t_job& job, planning.jobs) {
+		print_job(opts, 0, job);
+	}
+}
+
+void	bench_print_time_constraints(const s_printing_options& opts, const s_planning& planning) {
+	BOOST_FOREACH(const rpc::t_job& job, planning.jobs) {
+		print_time_constraints(opts, 0, job.time_constraints);
+	}
+}
+
+void	bench_print_time_constraint(const s_printing_options& opts, const s_planning& planning) {
+	BOOST_FOREACH(const rpc::t_job& job, planning.jobs) {
+		BOOST_FOREACH(const rpc::t_time_constraint& tc, job.time_constraints) {
+			print_time_constraint(opts, 0, tc);
+		}
+	}
+}
+
+void	bench_print_resources(const s_printing_options& opts, const s_planning& planning) {
+	BOOST_FOREACH(const rpc::t_node& node, planning.nodes) {
+		print_resources(opts, 0, node.resources);
+	}
+}
+
+void	bench_print_resource(const s_printing_options& opts, const s_planning& planning) {
+	BOOST_FOREACH(const rpc::t_node& node, planning.nodes) {
+		BOOST_FOREACH(const rpc::t_resource& resource, node.resources) {
+			print_resource(opts, 0, resource);
+		}
+	}
+}
+
+static const struct {
+	const char*		name;
+	bench_function	function;
+} entry_points[] = {
+	{ "print_kv",				bench_print_kv },
+	{ "print_nodes",			bench_print_nodes },
+	{ "print_node",				bench_print_node },
+	{ "print_jobs",				bench_print_jobs },
+	{ "print_job",				bench_print_job },
+	{ "print_time_constraints",	bench_print_time_constraints },
+	{ "print_time_constraint",	bench_print_time_constraint },
+	{ "print_resources",		bench_print_resources },
+	{ "print_resource",			bench_print_resource }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//	planning
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * A small linear congruential generator: the plannings must be the same from
+ * one run to another
+ */
+class Bench_Random {
+public:
+	Bench_Random(const uint32_t& seed = 42) : _seed(seed) {
+	}
+
+	size_t	next(const size_t& max) {
+		this->_seed = this->_seed * 1103515245 + 12345;
+		return max == 0 ? 0 : (this->_seed >> 16) % max;
+	}
+
+private:
+	uint32_t	_seed;
+};
+
+/**
+ * Thrift's enums' values, to pick them without knowing them
+ */
+template<typename Map>
+std::vector<int>	enum_values(const Map& names) {
+	std::vector<int>	values;
+
+	for ( typename Map::const_iterator i = names.begin() ; i != names.end() ; ++i ) {
+		values.push_back(i->first);
+	}
+
+	return values;
+}
+
+void	build_planning(const size_t& jobs_count, const size_t& jobs_per_node, const size_t& fan_out, s_planning& planning) {
+	std::vector<int>	states = enum_values(rpc::_e_job_state_VALUES_TO_NAMES);
+	std::vector<int>	actions = enum_values(rpc::_e_rectype_action_VALUES_TO_NAMES);
+	std::vector<int>	tc_types = enum_values(rpc::_e_time_constraint_type_VALUES_TO_NAMES);
+	size_t				nodes_count = (jobs_count + jobs_per_node - 1) / jobs_per_node;
+	Bench_Random		random;
+
+	planning.jobs.clear();
+	planning.nodes.clear();
+	planning.jobs.resize(jobs_count);
+	planning.nodes.resize(nodes_count);
+
+	for ( size_t i = 0 ; i < jobs_count ; ++i ) {
+		rpc::t_job&	job = planning.jobs[i];
+		std::string	id = boost::lexical_cast<std::string>(i);
+		size_t		links;
+
+		job.name = "job_" + id;
+		job.domain = "bench";
+		job.node_name = "node_" + boost::lexical_cast<std::string>(i / jobs_per_node);
+		job.cmd_line = "/opt/batch/bin/run.sh --job job_" + id + " --date \"$(date +%F)\" >> /var/log/batch/job_" + id + ".log 2>&1";
+		job.state = static_cast<rpc::e_job_state::type>(states[random.next(states.size())]);
+		job.recovery_type.action = static_cast<rpc::e_rectype_action::type>(actions[random.next(actions.size())]);
+		job.return_code = random.next(4);
+		job.start_time = 1370476800 + random.next(86400);
+		job.stop_time = job.start_time + random.next(3600);
+		job.weight = 1 + random.next(10);
+
+		// Between 0 and 2 * fan_out links to the neighbours
+		links = random.next(2 * fan_out + 1);
+		for ( size_t l = 1 ; l <= links && i + l < jobs_count ; ++l ) {
+			job.nxt.push_back("job_" + boost::lexical_cast<std::string>(i + l));
+		}
+
+		links = random.next(2 * fan_out + 1);
+		for ( size_t l = 1 ; l <= links && l <= i ; ++l ) {
+			job.prv.push_back("job_" + boost::lexical_cast<std::string>(i - l));
+		}
+
+		links = random.next(3);
+		for ( size_t l = 0 ; l < links ; ++l ) {
+			rpc::t_time_constraint	tc;
+
+			tc.job_name = job.name;
+			tc.type = static_cast<rpc::e_time_constraint_type::type>(tc_types[random.next(tc_types.size())]);
+			tc.value = random.next(86400);
+			job.time_constraints.push_back(tc);
+		}
+	}
+
+	for ( size_t n = 0 ; n < nodes_count ; ++n ) {
+		rpc::t_node&	node = planning.nodes[n];
+		rpc::t_resource	resource;
+		size_t			first = n * jobs_per_node;
+
+		node.name = "node_" + boost::lexical_cast<std::string>(n);
+		node.domain_name = "bench";
+		node.weight = 1 + random.next(10);
+		node.jobs.assign(planning.jobs.begin() + first, planning.jobs.begin() + std::min(first + jobs_per_node, jobs_count));
+
+		resource.name = "cpu";
+		resource.initial_value = 16;
+		resource.current_value = random.next(17);
+		node.resources.push_back(resource);
+
+		resource.name = "memory";
+		resource.initial_value = 65536;
+		resource.current_value = random.next(65537);
+		node.resources.push_back(resource);
+	}
+
+	planning.kv["domain"] = "bench";
+	planning.kv["name"] = "node_0";
+	planning.kv["master"] = bool_to_string(true);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//	measures
+///////////////////////////////////////////////////////////////////////////////
+
+bool	run_bench(const s_printing_options& opts, const s_planning& planning, bench_function function, const size_t& iterations, s_bench_result& result) {
+	double	best = -1;
+	size_t	jobs_count = std::max<size_t>(planning.jobs.size(), 1);
+
+	for ( size_t i = 0 ; i < iterations ; ++i ) {
+		struct stat	output;
+
+		// Each run starts with an empty output
+		if ( ftruncate(STDOUT_FILENO, 0) != 0 || lseek(STDOUT_FILENO, 0, SEEK_SET) < 0 ) {
+			std::cerr << "Cannot reset the output: " << strerror(errno) << std::endl;
+			return false;
+		}
+
+		Allocation_Counter	allocations;
+		std::chrono::steady_clock::time_point	start = std::chrono::steady_clock::now();
+
+		function(opts, planning);
+		std::cout.flush();
+		fflush(stdout);
+
+		double	elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		size_t	allocations_count = allocations.count();
+
+		if ( fstat(STDOUT_FILENO, &output) != 0 ) {
+			std::cerr << "Cannot measure the output: " << strerror(errno) << std::endl;
+			return false;
+		}
+
+		if ( best >= 0 && elapsed >= best )
+			continue;
+
+		best = elapsed;
+		result.bytes = output.st_size;
+		result.ns_per_job = elapsed / jobs_count;
+		result.bytes_per_second = elapsed > 0 ? output.st_size / (elapsed / 1e9) : 0;
+		result.allocations_per_job = static_cast<double>(allocations_count) / jobs_count;
+	}
+
+	return best >= 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//	parsers
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The former split_line, kept as the reference
+ */
+bool	regex_split_line(const char& separator, const std::string& data, std::string& key, std::string& value) {
+	boost::regex	spaces("[[:space:]]+", boost::regex::perl);
+	boost::regex	comment_endl("#.*?$", boost::regex::perl);
+
+	std::string	line = data;
+	size_t		position = 0;
+
+	line = boost::regex_replace(line, spaces, "");
+	line = boost::regex_replace(line, comment_endl, "");
+
+	if ( line.length() == 0 )
+		return true;
+
+	position = line.find_first_of(separator);
+
+	if ( position == std::string::npos )
+		return false;
+
+	key	= line.substr(0, position);
+	value	= line.substr(position+1, line.length());
+
+	return key.length() != 0 && value.length() != 0;
+}
+
+size_t	bench_regex_split_line(const std::vector<std::string>& lines) {
+	std::string	key;
+	std::string	value;
+	size_t		keys = 0;
+
+	BOOST_FOREACH(const std::string& line, lines) {
+		key.clear();
+		if ( regex_split_line('=', line, key, value) == true && key.empty() == false )
+			keys++;
+	}
+
+	return keys;
+}
+
+size_t	bench_split_line_copy(const std::vector<std::string>& lines) {
+	std::string	key;
+	std::string	value;
+	size_t		keys = 0;
+
+	BOOST_FOREACH(const std::string& line, lines) {
+		if ( split_line('=', line, key, value) == true && key.empty() == false )
+			keys++;
+	}
+
+	return keys;
+}
+
+size_t	bench_split_line_view(const std::vector<std::string>& lines) {
+	boost::string_view	key;
+	boost::string_view	value;
+	size_t				keys = 0;
+
+	BOOST_FOREACH(const std::string& line, lines) {
+		if ( split_line('=', boost::string_view(line), key, value) == true && key.empty() == false )
+			keys++;
+	}
+
+	return keys;
+}
+
+static const struct {
+	const char*		name;
+	parser_function	function;
+} parsers[] = {
+	{ "regex",			bench_regex_split_line },
+	{ "split_line",		bench_split_line_copy },
+	{ "split_line_view",	bench_split_line_view }
+};
+
+void	build_definition_lines(const s_planning& planning, std::vector<std::string>& lines) {
+	lines.clear();
+
+	BOOST_FOREACH(const rpc::t_job& job, planning.jobs) {
+		lines.push_back("# " + job.name);
+		lines.push_back("name = " + job.name);
+		lines.push_back("node_name = " + job.node_name);
+		lines.push_back("cmd_line = " + job.cmd_line);
+		lines.push_back("weight = " + boost::lexical_cast<std::string>(job.weight));
+		if ( job.nxt.empty() == false )
+			lines.push_back("nxt = " + boost::algorithm::join(job.nxt, ","));
+		if ( job.prv.empty() == false )
+			lines.push_back("prv = " + boost::algorithm::join(job.prv, ",") + " # dependencies");
+		lines.push_back("");
+	}
+}
+
+bool	bench_parsers(const std::vector<size_t>& sizes, const size_t& jobs_per_node, const size_t& fan_out, const size_t& iterations) {
+	printf("%-10s %-10s %-16s %14s %12s\n", "jobs", "lines", "parser", "lines/s", "allocs/line");
+
+	BOOST_FOREACH(const size_t& jobs_count, sizes) {
+		s_planning					planning;
+		std::vector<std::string>	lines;
+
+		build_planning(jobs_count, jobs_per_node, fan_out, planning);
+		build_definition_lines(planning, lines);
+
+		for ( size_t p = 0 ; p < sizeof(parsers) / sizeof(parsers[0]) ; ++p ) {
+			double	best = -1;
+			size_t	allocations_count = 0;
+
+			for ( size_t i = 0 ; i < iterations ; ++i ) {
+				Allocation_Counter	allocations;
+				std::chrono::steady_clock::time_point	start = std::chrono::steady_clock::now();
+
+				if ( parsers[p].function(lines) == 0 && lines.empty() == false ) {
+					std::cerr << parsers[p].name << " did not find any key" << std::endl;
+					return false;
+				}
+
+				double	elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+				if ( best < 0 || elapsed < best ) {
+					best = elapsed;
+					allocations_count = allocations.count();
+				}
+			}
+
+			printf("%-10zu %-10zu %-16s %14.0f %12.2f\n", jobs_count, lines.size(), parsers[p].name,
+				best > 0 ? lines.size() / best : 0, lines.empty() ? 0 : static_cast<double>(allocations_count) / lines.size());
+			fflush(stdout);
+		}
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//	conversions
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Each function converts the enums of every job and returns the number of
+ * conversions. The results are summed in sink so that they are not optimized
+ * away. The parsed names come from the tables: they are NUL-terminated.
+ */
+
+static size_t	sink = 0;
+
+size_t	bench_job_state_string(const rpc::v_jobs& jobs) {
+	BOOST_FOREACH(const rpc::t_job& job, jobs) {
+		sink += build_string_from_job_state(job.state).size();
+	}
+	return jobs.size();
+}
+
+size_t	bench_job_state_view(const rpc::v_jobs& jobs) {
+	BOOST_FOREACH(const rpc::t_job& job, jobs) {
+		sink += job_state_to_string(job.state).size();
+	}
+	return jobs.size();
+}
+
+size_t	bench_job_state_parse_legacy(const rpc::v_jobs& jobs) {
+	BOOST_FOREACH(const rpc::t_job& job, jobs) {
+		sink += build_job_state_from_string(job_state_to_string(job.state).data());
+	}
+	return jobs.size();
+}
+
+size_t	bench_job_state_parse_table(const rpc::v_jobs& jobs) {
+	rpc::e_job_state::type	state;
+
+	BOOST_FOREACH(const rpc::t_job& job, jobs) {
+		if ( job_state_from_string(job_state_to_string(job.state), state) == true )
+			sink += state;
+	}
+	return jobs.size();
+}
+
+size_t	bench_rectype_action_string(const rpc::v_jobs& jobs) {
+	BOOST_FOREACH(const rpc::t_job& job, jobs) {
+		sink += build_string_from_rectype_action(job.recovery_type.action).size();
+	}
+	return jobs.size();
+}
+
+size_t	bench_rectype_action_view(const rpc::v_jobs& jobs) {
+	BOOST_FOREACH(const rpc::t_job& job, jobs) {
+		sink += rectype_action_to_string(job.recovery_type.action).size();
+	}
+	return jobs.size();
+}
+
+size_t	bench_rectype_action_parse_legacy(const rpc::v_jobs& jobs) {
+	BOOST_FOREACH(const rpc::t_job& job, jobs) {
+		sink += build_rectype_action_from_string(rectype_action_to_string(job.recovery_type.action).data());
+	}
+	return jobs.size();
+}
+
+size_t	bench_rectype_action_parse_table(const rpc::v_jobs& jobs) {
+	rpc::e_rectype_action::type	action;
+
+	BOOST_FOREACH(const rpc::t_job& job, jobs) {
+		if ( rectype_action_from_string(rectype_action_to_string(job.recovery_type.action), action) == true )
+			sink += action;
+	}
+	return jobs.size();
+}
+
+size_t	bench_tc_type_string(const rpc::v_jobs& jobs) {
+	size_t	count = 0;
+
+	BOOST_FOREACH(const rpc::t_job& job, jobs) {
+		BOOST_FOREACH(const rpc::t_time_constraint& tc, job.time_constraints) {
+			sink += build_string_from_time_constraint_type(tc.type).size();
+			count++;
+		}
+	}
+	return count;
+}
+
+size_t	bench_tc_type_view(const rpc::v_jobs& jobs) {
+	size_t	count = 0;
+
+	BOOST_FOREACH(const rpc::t_job& job, jobs) {
+		BOOST_FOREACH(const rpc::t_time_constraint& tc, job.time_constraints) {
+			sink += time_constraint_type_to_string(tc.type).size();
+			count++;
+		}
+	}
+	return count;
+}
+
+size_t	bench_tc_type_parse_legacy(const rpc::v_jobs& jobs) {
+	size_t	count = 0;
+
+	BOOST_FOREACH(const rpc::t_job& job, jobs) {
+		BOOST_FOREACH(const rpc::t_time_constraint& tc, job.time_constraints) {
+			sink += build_time_constraint_type_from_string(time_constraint_type_to_string(tc.type).data());
+			count++;
+		}
+	}
+	return count;
+}
+
+size_t	bench_tc_type_parse_table(const rpc::v_jobs& jobs) {
+	rpc::e_time_constraint_type::type	type;
+	size_t								count = 0;
+
+	BOOST_FOREACH(const rpc::t_job& job, jobs) {
+		BOOST_FOREACH(const rpc::t_time_constraint& tc, job.time_constraints) {
+			if ( time_constraint_type_from_string(time_constraint_type_to_string(tc.type), type) == true )
+				sink += type;
+			count++;
+		}
+	}
+	return count;
+}
+
+static const struct {
+	const char*			name;
+	conversion_function	function;
+} conversions[] = {
+	{ "job_state/string",			bench_job_state_string },
+	{ "job_state/view",				bench_job_state_view },
+	{ "job_state/parse_legacy",		bench_job_state_parse_legacy },
+	{ "job_state/parse_table",		bench_job_state_parse_table },
+	{ "rectype_action/string",		bench_rectype_action_string },
+	{ "rectype_action/view",		bench_rectype_action_view },
+	{ "rectype_action/parse_legacy",	bench_rectype_action_parse_legacy },
+	{ "rectype_action/parse_table",	bench_rectype_action_parse_table },
+	{ "tc_type/string",				bench_tc_type_string },
+	{ "tc_type/view",				bench_tc_type_view },
+	{ "tc_type/parse_legacy",		bench_tc_type_parse_legacy },
+	{ "tc_type/parse_table",		bench_tc_type_parse_table }
+};
+
+bool	bench_conversions(const std::vector<size_t>& sizes, const size_t& jobs_per_node, const size_t& fan_out, const size_t& iterations) {
+	printf("%-10s %-28s %14s %12s\n", "jobs", "conversion", "conv/s", "allocs/conv");
+
+	BOOST_FOREACH(const size_t& jobs_count, sizes) {
+		s_planning	planning;
+
+		build_planning(jobs_count, jobs_per_node, fan_out, planning);
+
+		for ( size_t c = 0 ; c < sizeof(conversions) / sizeof(conversions[0]) ; ++c ) {
+			double	best = -1;
+			size_t	count = 0;
+			size_t	allocations_count = 0;
+
+			for ( size_t i = 0 ; i < iterations ; ++i ) {
+				Allocation_Counter	allocations;
+				std::chrono::steady_clock::time_point	start = std::chrono::steady_clock::now();
+
+				count = conversions[c].function(planning.jobs);
+
+				double	elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+				if ( best < 0 || elapsed < best ) {
+					best = elapsed;
+					allocations_count = allocations.count();
+				}
+			}
+
+			printf("%-10zu %-28s %14.0f %12.2f\n", jobs_count, conversions[c].name,
+				best > 0 ? count / best : 0, count == 0 ? 0 : static_cast<double>(allocations_count) / count);
+			fflush(stdout);
+		}
+	}
+
+	return sink > 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//	interning
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * string_memory
+ *
+ * @return	the heap bytes of the string, none when its text is stored inside
+ *			the object (small string optimization)
+ */
+static size_t	string_memory(const std::string& s) {
+	const char*	object = reinterpret_cast<const char*>(&s);
+
+	if ( s.data() >= object && s.data() < object + sizeof(s) )
+		return 0;
+
+	return s.capacity() + 1;
+}
+
+static size_t	strings_memory(const std::vector<std::string>& v) {
+	size_t	result = v.capacity() * sizeof(std::string);
+
+	BOOST_FOREACH(const std::string& s, v) {
+		result += string_memory(s);
+	}
+
+	return result;
+}
+
+size_t	jobs_memory(const rpc::v_jobs& jobs) {
+	size_t	result = jobs.capacity() * sizeof(rpc::t_job);
+
+	BOOST_FOREACH(const rpc::t_job& job, jobs) {
+		result += string_memory(job.name) + string_memory(job.domain) + string_memory(job.node_name) + string_memory(job.cmd_line);
+		result += string_memory(job.recovery_type.short_label) + string_memory(job.recovery_type.label);
+		result += strings_memory(job.nxt) + strings_memory(job.prv);
+		result += job.time_constraints.capacity() * sizeof(rpc::t_time_constraint);
+
+		BOOST_FOREACH(const rpc::t_time_constraint& tc, job.time_constraints) {
+			result += string_memory(tc.job_name);
+		}
+	}
+
+	return result;
+}
+
+bool	bench_interning(const std::vector<size_t>& sizes, const size_t& jobs_per_node, const size_t& fan_out) {
+	printf("%-10s %14s %14s %8s %10s %12s\n", "jobs", "v_jobs bytes", "interned bytes", "ratio", "strings", "intern ns/job");
+
+	BOOST_FOREACH(const size_t& jobs_count, sizes) {
+		s_planning	planning;
+		String_Pool	pool;
+		Job_Set		set(pool);
+		rpc::t_job	job;
+		size_t		before;
+		size_t		after;
+
+		build_planning(jobs_count, jobs_per_node, fan_out, planning);
+
+		std::chrono::steady_clock::time_point	start = std::chrono::steady_clock::now();
+		set.add(planning.jobs);
+		double	elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		// The jobs must come back unchanged
+		for ( size_t i = 0 ; i < set.size() ; ++i ) {
+			set.get(i, job);
+
+			if ( job.name != planning.jobs[i].name || job.nxt != planning.jobs[i].nxt || job.cmd_line != planning.jobs[i].cmd_line ) {
+				std::cerr << "job " << i << " differs once interned" << std::endl;
+				return false;
+			}
+		}
+
+		before = jobs_memory(planning.jobs);
+		after = set.memory() + pool.memory();
+
+		printf("%-10zu %14zu %14zu %8.2f %10zu %12.1f\n", jobs_count, before, after,
+			after > 0 ? static_cast<double>(before) / after : 0, pool.size(), jobs_count > 0 ? elapsed * 1e9 / jobs_count : 0);
+		fflush(stdout);
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//	attributes
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The former update_node, kept as the reference
+ */
+void	legacy_update_node(const std::string& key, const std::string& value, rpc::t_node& node) {
+	if ( key.compare("name") == 0 ) {
+		node.name = value;
+	} else if ( key.compare("weight") == 0 ) {
+		node.weight = boost::lexical_cast<int>(value);
+	} else if ( key.compare("domain_name") == 0 ) {
+		node.domain_name = value;
+	}
+}
+
+/**
+ * The former update_job, kept as the reference: a recovery_type or a time
+ * constraint without its ':' fields throws std::out_of_range
+ */
+void	legacy_update_job(const std::string& key, const std::string& value, rpc::t_job& job) {
+	if ( key.compare("name") == 0 ) {
+		job.name = value;
+	} else if ( key.compare("weight") == 0 ) {
+		job.weight = boost::lexical_cast<int>(value);
+	} else if ( key.compare("cmd_line") == 0 ) {
+		job.cmd_line = value;
+	} else if ( key.compare("node_name") == 0 ) {
+		job.node_name = value;
+	} else if ( key.compare("nxt") == 0 ) {
+		boost::split(job.nxt, value, boost::is_any_of(",;"));
+	} else if ( key.compare("prv") == 0 ) {
+		boost::split(job.prv, value, boost::is_any_of(",;"));
+	} else if ( key.compare("recovery_type") == 0 ) {
+		std::vector<std::string>	splitted_rt;
+
+		boost::split(splitted_rt, value, boost::is_any_of(":"));
+
+		job.recovery_type.short_label = splitted_rt.at(0);
+		job.recovery_type.label = splitted_rt.at(1);
+		job.recovery_type.action = build_rectype_action_from_string(splitted_rt.at(2).c_str());
+	} else if ( key.compare("time_constraints") == 0 ) {
+		std::vector<std::string>	list_of_tc;
+
+		boost::split(list_of_tc, value, boost::is_any_of(",;"));
+
+		BOOST_FOREACH(const std::string& tc, list_of_tc) {
+			std::vector<std::string>	splitted_tc;
+			rpc::t_time_constraint		time_constraint;
+
+			boost::algorithm::split(splitted_tc, tc, boost::is_any_of(":"));
+			time_constraint.job_name = job.name;
+			time_constraint.type = build_time_constraint_type_from_string(splitted_tc.at(0).c_str());
+			time_constraint.value = build_unix_time_from_hhmm_time(splitted_tc.at(1));
+
+			job.time_constraints.push_back(time_constraint);
+		}
+	}
+}
+
+/**
+ * hhmm
+ *
+ * @param	seconds	the number of seconds since midnight
+ * @return	the time as hhmm
+ */
+static std::string	hhmm(const rpc::integer& seconds) {
+	char	text[8];
+
+	snprintf(text, sizeof(text), "%02d%02d", static_cast<int>(seconds / 3600 % 24), static_cast<int>(seconds / 60 % 60));
+	return text;
+}
+
+void	build_attribute_lines(const s_planning& planning, s_attribute_lines& lines) {
+	lines.jobs.clear();
+	lines.nodes.clear();
+	lines.times.clear();
+
+	BOOST_FOREACH(const rpc::t_job& job, planning.jobs) {
+		std::string	tcs;
+
+		lines.jobs.push_back("name = " + job.name);
+		lines.jobs.push_back("node_name = " + job.node_name);
+		lines.jobs.push_back("cmd_line = " + job.cmd_line);
+		lines.jobs.push_back("weight = " + boost::lexical_cast<std::string>(job.weight));
+		if ( job.nxt.empty() == false )
+			lines.jobs.push_back("nxt = " + boost::algorithm::join(job.nxt, ","));
+		if ( job.prv.empty() == false )
+			lines.jobs.push_back("prv = " + boost::algorithm::join(job.prv, ","));
+		lines.jobs.push_back("recovery_type = rc" + boost::lexical_cast<std::string>(job.return_code) + ":retry:" + rectype_action_to_string(job.recovery_type.action).to_string());
+
+		BOOST_FOREACH(const rpc::t_time_constraint& tc, job.time_constraints) {
+			lines.times.push_back(hhmm(tc.value));
+
+			if ( tcs.empty() == false )
+				tcs += ',';
+			tcs += time_constraint_type_to_string(tc.type).to_string() + ":" + lines.times.back();
+		}
+
+		if ( tcs.empty() == false )
+			lines.jobs.push_back("time_constraints = " + tcs);
+	}
+
+	BOOST_FOREACH(const rpc::t_node& node, planning.nodes) {
+		lines.nodes.push_back("name = " + node.name);
+		lines.nodes.push_back("domain_name = " + node.domain_name);
+		lines.nodes.push_back("weight = " + boost::lexical_cast<std::string>(node.weight));
+	}
+}
+
+/**
+ * write_json_job
+ *
+ * Writes the job with the members read by read_json_job, the time
+ * constraints use hh:mm values
+ */
+static void	write_json_job(Json_Writer& writer, const rpc::t_job& job) {
+	writer.begin_object();
+	writer.member("name", job.name);
+	writer.member("node_name", job.node_name);
+	writer.member("cmd_line", job.cmd_line);
+	writer.member("state", job_state_to_string(job.state));
+	writer.member("weight", job.weight);
+	writer.member("return_code", job.return_code);
+	writer.member("start_time", job.start_time);
+	writer.member("stop_time", job.stop_time);
+	writer.member("nxt", job.nxt);
+	writer.member("prv", job.prv);
+
+	writer.key("recovery_type");
+	writer.begin_object();
+	writer.member("short_label", "rc" + boost::lexical_cast<std::string>(job.return_code));
+	writer.member("label", "retry");
+	writer.member("action", rectype_action_to_string(job.recovery_type.action));
+	writer.end_object();
+
+	writer.key("time_constraints");
+	writer.begin_array();
+	BOOST_FOREACH(const rpc::t_time_constraint& tc, job.time_constraints) {
+		std::string	time = hhmm(tc.value);
+
+		writer.begin_object();
+		writer.member("type", time_constraint_type_to_string(tc.type));
+		writer.member("value", time.substr(0, 2) + ":" + time.substr(2));
+		writer.end_object();
+	}
+	writer.end_array();
+
+	writer.end_object();
+}
+
+void	build_json_documents(const s_planning& planning, std::vector<std::string>& documents) {
+	Output_Buffer	buffer;
+	Json_Writer		writer(buffer, false, ' ');
+
+	documents.clear();
+
+	BOOST_FOREACH(const rpc::t_job& job, planning.jobs) {
+		buffer.clear();
+		write_json_job(writer, job);
+		documents.push_back(std::string(buffer.data(), buffer.size()));
+	}
+
+	BOOST_FOREACH(const rpc::t_node& node, planning.nodes) {
+		buffer.clear();
+		writer.begin_object();
+		writer.member("name", node.name);
+		writer.member("domain_name", node.domain_name);
+		writer.member("weight", node.weight);
+
+		writer.key("resources");
+		writer.begin_array();
+		BOOST_FOREACH(const rpc::t_resource& resource, node.resources) {
+			writer.begin_object();
+			writer.member("name", resource.name);
+			writer.member("current_value", resource.current_value);
+			writer.member("initial_value", resource.initial_value);
+			writer.end_object();
+		}
+		writer.end_array();
+
+		writer.key("jobs");
+		writer.begin_array();
+		BOOST_FOREACH(const rpc::t_job& job, node.jobs) {
+			write_json_job(writer, job);
+		}
+		writer.end_array();
+
+		writer.end_object();
+		documents.push_back(std::string(buffer.data(), buffer.size()));
+	}
+}
+
+/*
+ * Each function parses every line and returns the number of attributes
+ * accepted. A rejected attribute is not an error: the legacy functions throw
+ * on some values of the planning's hh:mm times.
+ */
+
+size_t	bench_attributes_split_line(const std::vector<std::string>& lines) {
+	boost::string_view	key;
+	boost::string_view	value;
+	const char*			error = NULL;
+	size_t				count = 0;
+
+	BOOST_FOREACH(const std::string& line, lines) {
+		if ( split_line('=', boost::string_view(line), key, value, error) == true && key.empty() == false )
+			count++;
+	}
+
+	return count;
+}
+
+size_t	bench_attributes_legacy_update_job(const std::vector<std::string>& lines) {
+	std::string	key;
+	std::string	value;
+	rpc::t_job	job;
+	size_t		count = 0;
+
+	BOOST_FOREACH(const std::string& line, lines) {
+		if ( split_line('=', line, key, value) == false )
+			continue;
+
+		// Each job starts with its name
+		if ( key.compare("name") == 0 )
+			job = rpc::t_job();
+
+		try {
+			legacy_update_job(key, value, job);
+			count++;
+		} catch (const std::exception& e) {
+		}
+	}
+
+	sink += job.time_constraints.size();
+	return count;
+}
+
+size_t	bench_attributes_update_job(const std::vector<std::string>& lines) {
+	std::string	key;
+	std::string	value;
+	rpc::t_job	job;
+	size_t		count = 0;
+
+	BOOST_FOREACH(const std::string& line, lines) {
+		if ( split_line('=', line, key, value) == false )
+			continue;
+
+		if ( key.compare("name") == 0 )
+			job = rpc::t_job();
+
+		try {
+			if ( update_job(key, value, job) == true )
+				count++;
+		} catch (const std::exception& e) {
+		}
+	}
+
+	sink += job.time_constraints.size();
+	return count;
+}
+
+size_t	bench_attributes_update_job_cache(const std::vector<std::string>& lines) {
+	std::string	key;
+	std::string	value;
+	rpc::t_job	job;
+	Hhmm_Cache	cache;
+	size_t		count = 0;
+
+	BOOST_FOREACH(const std::string& line, lines) {
+		if ( split_line('=', line, key, value) == false )
+			continue;
+
+		if ( key.compare("name") == 0 )
+			job = rpc::t_job();
+
+		try {
+			if ( update_job(key, value, job, &cache) == true )
+				count++;
+		} catch (const std::exception& e) {
+		}
+	}
+
+	sink += job.time_constraints.size();
+	return count;
+}
+
+size_t	bench_attributes_legacy_update_node(const std::vector<std::string>& lines) {
+	std::string	key;
+	std::string	value;
+	rpc::t_node	node;
+	size_t		count = 0;
+
+	BOOST_FOREACH(const std::string& line, lines) {
+		if ( split_line('=', line, key, value) == false )
+			continue;
+
+		try {
+			legacy_update_node(key, value, node);
+			count++;
+		} catch (const std::exception& e) {
+		}
+	}
+
+	sink += node.name.size();
+	return count;
+}
+
+size_t	bench_attributes_update_node(const std::vector<std::string>& lines) {
+	std::string	key;
+	std::string	value;
+	rpc::t_node	node;
+	size_t		count = 0;
+
+	BOOST_FOREACH(const std::string& line, lines) {
+		if ( split_line('=', line, key, value) == false )
+			continue;
+
+		try {
+			if ( update_node(key, value, node) == true )
+				count++;
+		} catch (const std::exception& e) {
+		}
+	}
+
+	sink += node.name.size();
+	return count;
+}
+
+size_t	bench_attributes_legacy_hhmm(const std::vector<std::string>& times) {
+	size_t	count = 0;
+
+	BOOST_FOREACH(const std::string& time, times) {
+		try {
+			sink += build_unix_time_from_hhmm_time(time);
+			count++;
+		} catch (const std::exception& e) {
+		}
+	}
+
+	return count;
+}
+
+size_t	bench_attributes_hhmm(const std::vector<std::string>& times) {
+	int		minutes = 0;
+	size_t	count = 0;
+
+	BOOST_FOREACH(const std::string& time, times) {
+		if ( parse_hhmm(time, minutes) == true ) {
+			sink += resolve_hhmm(minutes);
+			count++;
+		}
+	}
+
+	return count;
+}
+
+size_t	bench_attributes_hhmm_cache(const std::vector<std::string>& times) {
+	Hhmm_Cache	cache;
+	int			minutes = 0;
+	size_t		count = 0;
+
+	BOOST_FOREACH(const std::string& time, times) {
+		if ( parse_hhmm(time, minutes) == true ) {
+			sink += cache.resolve(minutes);
+			count++;
+		}
+	}
+
+	return count;
+}
+
+/**
+ * The lines given to an attribute parser
+ */
+enum e_attribute_input {
+	ATTRIBUTE_INPUT_JOBS,
+	ATTRIBUTE_INPUT_NODES,
+	ATTRIBUTE_INPUT_TIMES
+};
+
+static const struct {
+	const char*			name;
+	e_attribute_input	input;
+	parser_function		function;
+} attribute_parsers[] = {
+	{ "split_line",				ATTRIBUTE_INPUT_JOBS,	bench_attributes_split_line },
+	{ "update_job/legacy",		ATTRIBUTE_INPUT_JOBS,	bench_attributes_legacy_update_job },
+	{ "update_job",				ATTRIBUTE_INPUT_JOBS,	bench_attributes_update_job },
+	{ "update_job/cache",		ATTRIBUTE_INPUT_JOBS,	bench_attributes_update_job_cache },
+	{ "update_node/legacy",		ATTRIBUTE_INPUT_NODES,	bench_attributes_legacy_update_node },
+	{ "update_node",			ATTRIBUTE_INPUT_NODES,	bench_attributes_update_node },
+	{ "hhmm/legacy",			ATTRIBUTE_INPUT_TIMES,	bench_attributes_legacy_hhmm },
+	{ "hhmm/parse_hhmm",		ATTRIBUTE_INPUT_TIMES,	bench_attributes_hhmm },
+	{ "hhmm/cache",				ATTRIBUTE_INPUT_TIMES,	bench_attributes_hhmm_cache }
+};
+
+static const std::vector<std::string>&	attribute_input(const s_attribute_lines& lines, const e_attribute_input& input) {
+	switch (input) {
+		case ATTRIBUTE_INPUT_NODES:
+			return lines.nodes;
+		case ATTRIBUTE_INPUT_TIMES:
+			return lines.times;
+		default:
+			return lines.jobs;
+	}
+}
+
+bool	bench_attributes(const std::vector<size_t>& sizes, const size_t& jobs_per_node, const size_t& fan_out, const size_t& iterations) {
+	printf("%-10s %-20s %12s %10s %12s %12s\n", "jobs", "parser", "attributes", "MB/s", "ns/attribute", "allocs/attr");
+
+	BOOST_FOREACH(const size_t& jobs_count, sizes) {
+		s_planning			planning;
+		s_attribute_lines	lines;
+
+		build_planning(jobs_count, jobs_per_node, fan_out, planning);
+		build_attribute_lines(planning, lines);
+
+		for ( size_t p = 0 ; p < sizeof(attribute_parsers) / sizeof(attribute_parsers[0]) ; ++p ) {
+			const std::vector<std::string>&	input = attribute_input(lines, attribute_parsers[p].input);
+			double	best = -1;
+			size_t	bytes = 0;
+			size_t	count = 0;
+			size_t	allocations_count = 0;
+
+			BOOST_FOREACH(const std::string& line, input) {
+				bytes += line.size() + 1;
+			}
+
+			for ( size_t i = 0 ; i < iterations ; ++i ) {
+				Allocation_Counter	allocations;
+				std::chrono::steady_clock::time_point	start = std::chrono::steady_clock::now();
+
+				count = attribute_parsers[p].function(input);
+
+				double	elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+				if ( best < 0 || elapsed < best ) {
+					best = elapsed;
+					allocations_count = allocations.count();
+				}
+			}
+
+			printf("%-10zu %-20s %12zu %10.1f %12.1f %12.2f\n", jobs_count, attribute_parsers[p].name, count,
+				best > 0 ? bytes / best / 1e6 : 0, input.empty() ? 0 : best * 1e9 / input.size(),
+				input.empty() ? 0 : static_cast<double>(allocations_count) / input.size());
+			fflush(stdout);
+		}
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//	fuzzing
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The values most likely to break a parser
+ */
+static const char*	fuzz_tokens[] = {
+	"", " ", "=", ":", "::", ",", ";", ",,", "#", "\t", "at:", ":1230", "at:12", "at:2400", "at:12:30",
+	"before:99:99", "after:-1", "s:l", "s:l:", "s:l:restart:x", "stop", "-1", "9223372036854775808",
+	"name", "weight", "nxt", "prv", "recovery_type", "time_constraints", "domain_name", "jobs",
+	"{", "}", "[", "]", "\"", "\\", "\\u", "\\ud800", "\\udc00", "\\u00e9", "null", "true", "1e999", "-0", "[[[[[[[[", "{\"\":"
+};
+
+/**
+ * fuzz_line
+ *
+ * Mutates a valid line: bytes are removed, inserted or replaced by the
+ * tokens, the line can be cut or its value replaced
+ */
+static std::string	fuzz_line(Bench_Random& random, const std::vector<std::string>& lines) {
+	std::string	line = lines[random.next(lines.size())];
+	size_t		mutations = 1 + random.next(4);
+	size_t		tokens_count = sizeof(fuzz_tokens) / sizeof(fuzz_tokens[0]);
+
+	for ( size_t m = 0 ; m < mutations ; ++m ) {
+		size_t	position = random.next(line.size() + 1);
+
+		switch ( random.next(6) ) {
+			case 0:
+				line.erase(position, 1 + random.next(4));
+				break;
+			case 1:
+				line.insert(position, 1, static_cast<char>(random.next(256)));
+				break;
+			case 2:
+				line.insert(position, fuzz_tokens[random.next(tokens_count)]);
+				break;
+			case 3:
+				line.resize(position);
+				break;
+			case 4:
+				position = line.find('=');
+				if ( position != std::string::npos )
+					line.replace(position + 1, std::string::npos, fuzz_tokens[random.next(tokens_count)]);
+				break;
+			default:
+				line += fuzz_tokens[random.next(tokens_count)];
+		}
+	}
+
+	return line;
+}
+
+/**
+ * @brief The s_fuzz_result struct
+ *
+ * What a fuzzed function did with the inputs
+ */
+struct s_fuzz_result {
+	s_fuzz_result() : inputs(0), accepted(0), rejected(0), thrown(0), out_of_range(0), unexpected(0) {
+	}
+
+	size_t	inputs;
+	size_t	accepted;
+	size_t	rejected;
+
+	// Documented exceptions: std::invalid_argument and boost::bad_lexical_cast
+	size_t	thrown;
+
+	// The .at() failures of the legacy functions
+	size_t	out_of_range;
+
+	// Any other exception or a broken invariant
+	size_t	unexpected;
+};
+
+/**
+ * fuzz_call
+ *
+ * Calls the function and sorts its outcome
+ *
+ * @return	false on an unexpected outcome
+ */
+template<typename Function>
+static bool	fuzz_call(s_fuzz_result& result, Function function) {
+	result.inputs++;
+
+	try {
+		if ( function() == true )
+			result.accepted++;
+		else
+			result.rejected++;
+		return true;
+	} catch (const std::out_of_range& e) {
+		result.out_of_range++;
+		return false;
+	} catch (const std::invalid_argument& e) {
+		result.thrown++;
+		return true;
+	} catch (const boost::bad_lexical_cast& e) {
+		result.thrown++;
+		return true;
+	} catch (...) {
+	}
+
+	result.unexpected++;
+	return false;
+}
+
+/*
+ * The fuzzed functions: they return true when the input is accepted
+ */
+
+static bool	fuzz_split_line(const std::string& line) {
+	boost::string_view	key;
+	boost::string_view	value;
+	const char*			error = NULL;
+
+	if ( split_line('=', boost::string_view(line), key, value, error) == false )
+		return false;
+
+	// The views must stay inside the line
+	if ( key.empty() == false && ( key.data() < line.data() || value.data() + value.size() > line.data() + line.size() ) )
+		throw std::logic_error("split_line returned a view outside of the line");
+
+	return true;
+}
+
+static bool	fuzz_legacy_update_job(const std::string& key, const std::string& value) {
+	rpc::t_job	job;
+
+	legacy_update_job(key, value, job);
+	return true;
+}
+
+static bool	fuzz_update_job(const std::string& key, const std::string& value) {
+	rpc::t_job	job;
+
+	return update_job(key, value, job);
+}
+
+static bool	fuzz_legacy_update_node(const std::string& key, const std::string& value) {
+	rpc::t_node	node;
+
+	legacy_update_node(key, value, node);
+	return true;
+}
+
+static bool	fuzz_update_node(const std::string& key, const std::string& value) {
+	rpc::t_node	node;
+
+	return update_node(key, value, node);
+}
+
+static bool	fuzz_legacy_hhmm(const std::string& value) {
+	sink += build_unix_time_from_hhmm_time(value);
+	return true;
+}
+
+static bool	fuzz_parse_hhmm(const std::string& value) {
+	int	minutes = -1;
+
+	if ( parse_hhmm(value, minutes) == false )
+		return false;
+
+	if ( minutes < 0 || minutes >= HHMM_MINUTES_PER_DAY )
+		throw std::logic_error("parse_hhmm returned " + boost::lexical_cast<std::string>(minutes));
+
+	return true;
+}
+
+/**
+ * check_error_lines
+ *
+ * Throws if an error is reported outside of the input's lines
+ */
+static void	check_error_lines(const v_definition_errors& errors, const size_t& lines_count) {
+	BOOST_FOREACH(const s_definition_error& error, errors) {
+		if ( error.line == 0 || error.line > lines_count )
+			throw std::logic_error("error reported on line " + boost::lexical_cast<std::string>(error.line));
+	}
+}
+
+/**
+ * same_definitions
+ *
+ * @return	true if both results have the same jobs, in the same order, and
+ *			the same errors
+ */
+static bool	same_definitions(const s_job_definitions& a, const s_job_definitions& b) {
+	if ( a.jobs.size() != b.jobs.size() || a.invalid != b.invalid || a.errors.size() != b.errors.size() )
+		return false;
+
+	for ( size_t i = 0 ; i < a.jobs.size() ; ++i ) {
+		if ( a.jobs[i].name != b.jobs[i].name || a.jobs[i].cmd_line != b.jobs[i].cmd_line )
+			return false;
+	}
+
+	for ( size_t i = 0 ; i < a.errors.size() ; ++i ) {
+		if ( a.errors[i].line != b.errors[i].line || a.errors[i].message != b.errors[i].message )
+			return false;
+	}
+
+	return true;
+}
+
+static bool	fuzz_read_job_definitions(const std::string& stream) {
+	Definition_File		file;
+	s_job_definitions	result;
+	s_job_definitions	chunked;
+
+	file.open(stream.data(), stream.size(), 0);
+	read_job_definitions(file, "fuzz", 1, result);
+
+	// A mutated first line can make it a JSON stream
+	check_error_lines(result.errors, std::count(stream.begin(), stream.end(), '\n') + ( is_json(file) == true ? 1 : 0 ));
+
+	// Small parts parsed by several threads are cut at the blocks' ends
+	read_job_definitions(file, "fuzz", FUZZ_THREADS, chunked, FUZZ_CHUNK_SIZE);
+
+	if ( same_definitions(result, chunked) == false )
+		throw std::logic_error("the parts parsed by several threads give other definitions");
+
+	return result.invalid == 0;
+}
+
+static bool	fuzz_read_json_definitions(const std::string& stream) {
+	Definition_File		file;
+	s_job_definitions	result;
+
+	file.open(stream.data(), stream.size(), 0);
+	read_json_definitions(file, "fuzz", result);
+
+	// A syntax error can be reported at the end of the stream, after its last new line
+	check_error_lines(result.errors, std::count(stream.begin(), stream.end(), '\n') + 1);
+
+	return result.invalid == 0;
+}
+
+static bool	fuzz_read_job_definition(const std::string& document) {
+	Definition_File		file;
+	rpc::t_job			job;
+	v_definition_errors	errors;
+	bool				found = false;
+	bool				valid = true;
+
+	file.open(document.data(), document.size(), 0);
+	valid = read_job_definition(file, job, found, errors);
+	check_error_lines(errors, std::count(document.begin(), document.end(), '\n') + 1);
+
+	return valid == true && found == true;
+}
+
+static bool	fuzz_read_node_definition(const std::string& document) {
+	Definition_File		file;
+	rpc::t_node			node;
+	v_definition_errors	errors;
+	bool				found = false;
+	bool				valid = true;
+
+	file.open(document.data(), document.size(), 0);
+	valid = read_node_definition(file, node, found, errors);
+	check_error_lines(errors, std::count(document.begin(), document.end(), '\n') + 1);
+
+	return valid == true && found == true;
+}
+
+/**
+ * print_fuzz_input
+ *
+ * Writes the input that failed with its special characters escaped
+ */
+static void	print_fuzz_input(const char* name, const std::string& input) {
+	std::cerr << name << " failed on \"";
+
+	BOOST_FOREACH(const char& c, input) {
+		if ( c >= 0x20 && c < 0x7f && c != '\\' && c != '"' ) {
+			std::cerr << c;
+		} else {
+			char	escaped[8];
+
+			snprintf(escaped, sizeof(escaped), "\\x%02x", static_cast<unsigned char>(c));
+			std::cerr << escaped;
+		}
+	}
+
+	std::cerr << "\"" << std::endl;
+}
+
+bool	bench_fuzz(const size_t& inputs_count, const uint32_t& seed) {
+	s_planning			planning;
+	s_attribute_lines	lines;
+	Bench_Random		random(seed);
+	std::vector<std::string>	documents;
+	std::string			stream;
+	std::string			json_stream;
+	bool				robust = true;
+
+	// The legacy functions' failures are only reported
+	enum { LEGACY_UPDATE_JOB, UPDATE_JOB, LEGACY_UPDATE_NODE, UPDATE_NODE, LEGACY_HHMM, PARSE_HHMM, SPLIT_LINE, READ_JOB_DEFINITIONS,
+		READ_JSON_DEFINITIONS, READ_JOB_DEFINITION, READ_NODE_DEFINITION, FUZZ_TARGETS };
+	static const char*	names[] = { "update_job/legacy", "update_job", "update_node/legacy", "update_node", "hhmm/legacy", "hhmm/parse_hhmm", "split_line",
+		"read_job_definitions", "read_json_definitions", "read_job_definition", "read_node_definition" };
+	static const bool	legacy[] = { true, false, true, false, true, false, false, false, false, false, false };
+	s_fuzz_result		results[FUZZ_TARGETS];
+
+	build_planning(100, 10, 3, planning);
+	build_attribute_lines(planning, lines);
+	lines.jobs.insert(lines.jobs.end(), lines.nodes.begin(), lines.nodes.end());
+	build_json_documents(planning, documents);
+
+	for ( size_t i = 0 ; i < inputs_count ; ++i ) {
+		std::string			line = fuzz_line(random, lines.jobs);
+		std::string			time = fuzz_line(random, lines.times);
+		std::string			document = fuzz_line(random, documents);
+		std::string			key;
+		std::string			value;
+		boost::string_view	key_view;
+		boost::string_view	value_view;
+		const char*			error = NULL;
+		bool				valid = true;
+
+		// split_line must not throw and its views must stay inside the line
+		valid = fuzz_call(results[SPLIT_LINE], boost::bind(fuzz_split_line, boost::cref(line)));
+
+		if ( valid == false )
+			print_fuzz_input(names[SPLIT_LINE], line);
+
+		// The values are given as they are once the line is split
+		if ( split_line('=', boost::string_view(line), key_view, value_view, error) == true && key_view.empty() == false ) {
+			key = key_view.to_string();
+			value = value_view.to_string();
+
+			fuzz_call(results[LEGACY_UPDATE_JOB], boost::bind(fuzz_legacy_update_job, key, value));
+			fuzz_call(results[LEGACY_UPDATE_NODE], boost::bind(fuzz_legacy_update_node, key, value));
+
+			if ( fuzz_call(results[UPDATE_JOB], boost::bind(fuzz_update_job, key, value)) == false ) {
+				print_fuzz_input(names[UPDATE_JOB], line);
+				valid = false;
+			}
+
+			if ( fuzz_call(results[UPDATE_NODE], boost::bind(fuzz_update_node, key, value)) == false ) {
+				print_fuzz_input(names[UPDATE_NODE], line);
+				valid = false;
+			}
+		}
+
+		fuzz_call(results[LEGACY_HHMM], boost::bind(fuzz_legacy_hhmm, time));
+
+		if ( fuzz_call(results[PARSE_HHMM], boost::bind(fuzz_parse_hhmm, time)) == false ) {
+			print_fuzz_input(names[PARSE_HHMM], time);
+			valid = false;
+		}
+
+		// A job or a node alone, as given to add job and add node
+		if ( fuzz_call(results[READ_JOB_DEFINITION], boost::bind(fuzz_read_job_definition, boost::cref(document))) == false ) {
+			print_fuzz_input(names[READ_JOB_DEFINITION], document);
+			valid = false;
+		}
+
+		if ( fuzz_call(results[READ_NODE_DEFINITION], boost::bind(fuzz_read_node_definition, boost::cref(document))) == false ) {
+			print_fuzz_input(names[READ_NODE_DEFINITION], document);
+			valid = false;
+		}
+
+		// The lines are also gathered into streams of blocks, the documents into NDJSON streams
+		stream += line;
+		stream += random.next(8) == 0 ? "\n\n" : "\n";
+		json_stream += document;
+		json_stream += '\n';
+
+		if ( ( i + 1 ) % FUZZ_STREAM_INPUTS == 0 || i + 1 == inputs_count ) {
+			if ( fuzz_call(results[READ_JOB_DEFINITIONS], boost::bind(fuzz_read_job_definitions, boost::cref(stream))) == false ) {
+				print_fuzz_input(names[READ_JOB_DEFINITIONS], stream);
+				valid = false;
+			}
+
+			if ( fuzz_call(results[READ_JSON_DEFINITIONS], boost::bind(fuzz_read_json_definitions, boost::cref(json_stream))) == false ) {
+				print_fuzz_input(names[READ_JSON_DEFINITIONS], json_stream);
+				valid = false;
+			}
+
+			stream.clear();
+			json_stream.clear();
+		}
+
+		if ( valid == false )
+			robust = false;
+	}
+
+	printf("%-22s %10s %10s %10s %10s %12s %10s\n", "function", "inputs", "accepted", "rejected", "thrown", "out_of_range", "unexpected");
+
+	for ( size_t t = 0 ; t < FUZZ_TARGETS ; ++t ) {
+		printf("%-22s %10zu %10zu %10zu %10zu %12zu %10zu%s\n", names[t], results[t].inputs, results[t].accepted, results[t].rejected,
+			results[t].thrown, results[t].out_of_range, results[t].unexpected, legacy[t] == true ? " (reference)" : "");
+	}
+
+	return robust;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int	main(const int argc, char const* argv[]) {
+	boost::program_options::variables_map opts_variables;
+	boost::program_options::options_description desc("Allowed options");
+	s_printing_options			opts;
+	std::vector<std::string>	sizes;
+	std::vector<size_t>			jobs_counts;
+	std::vector<std::string>	outputs;
+	std::vector<std::string>	names;
+	std::string					output_file;
+	size_t						jobs_per_node;
+	size_t						fan_out;
+	size_t						iterations;
+	FILE*						report = NULL;
+	int							output = -1;
+
+	desc.add_options()
+		("help,h", "produce help")
+		("jobs", boost::program_options::value<std::string>()->default_value("1000,10000,100000,1000000"), "the plannings' sizes")
+		("jobs-per-node", boost::program_options::value<size_t>()->default_value(1000), "the number of jobs of each node")
+		("fan-out", boost::program_options::value<size_t>()->default_value(3), "the average number of nxt and prv links of a job")
+		("outputs", boost::program_options::value<std::string>()->default_value("plain,json,ndjson,table,csv,tsv,binary"), "the output types to measure")
+		("entry-points", boost::program_options::value<std::string>()->default_value("print_nodes,print_jobs"), "the print_* functions to measure (all: every one)")
+		("iterations", boost::program_options::value<size_t>()->default_value(3), "the number of runs, the best one is reported")
+		("render-threads", boost::program_options::value<size_t>()->default_value(1), "the number of threads used to render the lists")
+		("fields", boost::program_options::value<std::string>(), "the jobs' attributes to print (name,state,cmd_line...)")
+		("output-file", boost::program_options::value<std::string>()->default_value("ows-bench.out"), "the file receiving the rendered text")
+		("parser", "measure split_line on definition files of the plannings' jobs instead of the rendering")
+		("conversions", "measure the enum to string conversions of the plannings' jobs instead of the rendering")
+		("interning", "measure the memory used by the plannings' jobs once interned instead of the rendering")
+		("attributes", "measure split_line, update_job, update_node and the hh:mm parsers instead of the rendering")
+		("fuzz", boost::program_options::value<size_t>()->implicit_value(100000), "feed this number of mutated attributes to the parsers and check that they are rejected cleanly")
+		("seed", boost::program_options::value<uint32_t>()->default_value(42), "the fuzzer's first random number")
+	;
+
+	try {
+		boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), opts_variables);
+		boost::program_options::notify(opts_variables);
+	} catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if ( opts_variables.count("help") ) {
+		std::cout << desc << std::endl;
+		return EXIT_SUCCESS;
+	}
+
+	boost::split(sizes, opts_variables["jobs"].as<std::string>(), boost::is_any_of(","));
+	boost::split(outputs, opts_variables["outputs"].as<std::string>(), boost::is_any_of(","));
+	boost::split(names, opts_variables["entry-points"].as<std::string>(), boost::is_any_of(","));
+	jobs_per_node = opts_variables["jobs-per-node"].as<size_t>();
+	fan_out = opts_variables["fan-out"].as<size_t>();
+	iterations = opts_variables["iterations"].as<size_t>();
+	opts.render_threads = opts_variables["render-threads"].as<size_t>();
+	output_file = opts_variables["output-file"].as<std::string>();
+
+	if ( jobs_per_node == 0 || iterations == 0 || opts.render_threads == 0 ) {
+		std::cerr << "jobs-per-node, iterations and render-threads must be positive" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	if ( opts_variables.count("fields") && build_job_fields_from_string(opts_variables["fields"].as<std::string>(), opts.job_fields) == false )
+		return EXIT_FAILURE;
+
+	BOOST_FOREACH(const std::string& size, sizes) {
+		try {
+			jobs_counts.push_back(boost::lexical_cast<size_t>(size));
+		} catch (const boost::bad_lexical_cast& e) {
+			std::cerr << "Bad planning size '" << size << "'" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	if ( opts_variables.count("parser") )
+		return bench_parsers(jobs_counts, jobs_per_node, fan_out, iterations) == true ? EXIT_SUCCESS : EXIT_FAILURE;
+
+	if ( opts_variables.count("conversions") )
+		return bench_conversions(jobs_counts, jobs_per_node, fan_out, iterations) == true ? EXIT_SUCCESS : EXIT_FAILURE;
+
+	if ( opts_variables.count("interning") )
+		return bench_interning(jobs_counts, jobs_per_node, fan_out) == true ? EXIT_SUCCESS : EXIT_FAILURE;
+
+	if ( opts_variables.count("attributes") )
+		return bench_attributes(jobs_counts, jobs_per_node, fan_out, iterations) == true ? EXIT_SUCCESS : EXIT_FAILURE;
+
+	if ( opts_variables.count("fuzz") )
+		return bench_fuzz(opts_variables["fuzz"].as<size_t>(), opts_variables["seed"].as<uint32_t>()) == true ? EXIT_SUCCESS : EXIT_FAILURE;
+
+	if ( names.size() == 1 && names[0].compare("all") == 0 ) {
+		names.clear();
+		for ( size_t e = 0 ; e < sizeof(entry_points) / sizeof(entry_points[0]) ; ++e ) {
+			names.push_back(entry_points[e].name);
+		}
+	}
+
+	/*
+	 * The rendered text goes to the output file, the report to the real stdout
+	 */
+	output = open(output_file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if ( output < 0 ) {
+		std::cerr << "Cannot open '" << output_file << "': " << strerror(errno) << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	report = fdopen(dup(STDOUT_FILENO), "w");
+	if ( report == NULL || dup2(output, STDOUT_FILENO) < 0 ) {
+		std::cerr << "Cannot redirect the output: " << strerror(errno) << std::endl;
+		return EXIT_FAILURE;
+	}
+	close(output);
+
+	fprintf(report, "%-10s %-8s %-24s %12s %12s %12s %14s\n", "jobs", "output", "entry_point", "ns/job", "MB/s", "allocs/job", "bytes");
+
+	BOOST_FOREACH(const size_t& jobs_count, jobs_counts) {
+		s_planning	planning;
+
+		build_planning(jobs_count, jobs_per_node, fan_out, planning);
+
+		BOOST_FOREACH(const std::string& output_type, outputs) {
+			if ( build_output_type_from_string(output_type, opts.output_type) == false ) {
+				std::cerr << "Unknown output type '" << output_type << "'" << std::endl;
+				return EXIT_FAILURE;
+			}
+
+			BOOST_FOREACH(const std::string& name, names) {
+				bench_function	function = NULL;
+				s_bench_result	result;
+
+				for ( size_t e = 0 ; e < sizeof(entry_points) / sizeof(entry_points[0]) ; ++e ) {
+					if ( name.compare(entry_points[e].name) == 0 )
+						function = entry_points[e].function;
+				}
+
+				if ( function == NULL ) {
+					std::cerr << "Unknown entry point '" << name << "'" << std::endl;
+					return EXIT_FAILURE;
+				}
+
+				if ( run_bench(opts, planning, function, iterations, result) == false )
+					return EXIT_FAILURE;
+
+				fprintf(report, "%-10zu %-8s %-24s %12.1f %12.1f %12.2f %14zu\n",
+					jobs_count, output_type.c_str(), name.c_str(),
+					result.ns_per_job, result.bytes_per_second / (1024 * 1024), result.allocations_per_job, result.bytes);
+				fflush(report);
+			}
+		}
+	}
+
+	fclose(report);
+
+	return EXIT_SUCCESS;
+}
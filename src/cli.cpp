@@ -33,6 +33,11 @@
 if ( print_opts.verbose ) \
 	std::cout << text << std::endl;
 
+// Statistics go to stderr to keep the rendered output parsable
+#define VERBOSE_STAT(text) \
+if ( print_opts.verbose ) \
+	std::cerr << text << std::endl;
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #define RPC_EXEC(command) \
@@ -56,6 +61,7 @@ try { \
 	return CLI_ERROR; \
 } catch (std::exception& e) { \
 	std::cerr << "Undefined exception occured:" << e.what() << std::endl; \
+	client.set_broken(); \
 	return CLI_ERROR; \
 }
 
@@ -82,6 +88,7 @@ try { \
 	return CLI_ERROR; \
 } catch (const std::exception& e) { \
 	std::cerr << "Undefined exception occured:" << e.what() << std::endl; \
+	client.set_broken(); \
 	return CLI_ERROR; \
 }
 
@@ -95,6 +102,9 @@ bool	cli_add_commands(struct cli_def* cli) {
 	cli_register_command(cli, NULL, "close", cmd_close, PRIVILEGE_UNPRIVILEGED, MODE_CONNECTED, "Disconnect");
 	cli_register_command(cli, NULL, "hello", cmd_hello, PRIVILEGE_UNPRIVILEGED, MODE_CONNECTED, "Sends a hello request");
 
+	// snapshots
+	cli_register_command(cli, NULL, "load", cmd_load, PRIVILEGE_UNPRIVILEGED, MODE_ANY, "Print a binary snapshot");
+
 	// add
 	c = cli_register_command(cli, NULL, "add", NULL, PRIVILEGE_PRIVILEGED, MODE_CONNECTED, NULL);
 	cli_register_command(cli, c, "job", cmd_add_job, PRIVILEGE_PRIVILEGED, MODE_CONNECTED, "Add a job");
@@ -113,10 +123,18 @@ bool	cli_add_commands(struct cli_def* cli) {
 	cli_register_command(cli, c, "current planning", cmd_get_current_planning_name, PRIVILEGE_UNPRIVILEGED, MODE_CONNECTED, "Show the current planning name");
 	cli_register_command(cli, c, "available plannings", cmd_get_available_planning_names, PRIVILEGE_UNPRIVILEGED, MODE_CONNECTED, "Show the available planning names");
 
+	// watch
+	c = cli_register_command(cli, NULL, "watch", NULL, PRIVILEGE_UNPRIVILEGED, MODE_CONNECTED, NULL);
+	cli_register_command(cli, c, "jobs", cmd_watch_jobs, PRIVILEGE_UNPRIVILEGED, MODE_CONNECTED, "Print the changes of the jobs every interval");
+
 	// update
 	c = cli_register_command(cli, NULL, "update", NULL, PRIVILEGE_PRIVILEGED, MODE_CONNECTED, NULL);
 	cli_register_command(cli, c, "job", cmd_update_job, PRIVILEGE_PRIVILEGED, MODE_CONNECTED, "Update a job");
 
+	// import
+	c = cli_register_command(cli, NULL, "import", NULL, PRIVILEGE_PRIVILEGED, MODE_CONNECTED, NULL);
+	cli_register_command(cli, c, "jobs", cmd_import_jobs, PRIVILEGE_PRIVILEGED, MODE_CONNECTED, "Add the jobs of a definition file");
+
 	// use
 	cli_register_command(cli, NULL, "use", cmd_use, PRIVILEGE_UNPRIVILEGED, MODE_CONNECTED, "Use a planning");
 
@@ -131,14 +149,27 @@ bool	cli_add_commands(struct cli_def* cli) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-int	cmd_get_nodes(UNUSED(struct cli_def *cli), const char *command, UNUSED(char *argv[]), UNUSED(int argc)) {
-	rpc::v_nodes	nodes;
+int	cmd_get_nodes(UNUSED(struct cli_def *cli), const char *command, char *argv[], int argc) {
+	rpc::v_nodes		nodes;
+	s_printing_options	opts = print_opts;
 
 	VERBOSE_PRINT(command)
 
-	RPC_EXEC(client.get_handler()->get_nodes(nodes, routing))
+	if ( parse_printing_arguments(argv, argc, opts) == false )
+		return CLI_ERROR_ARG;
+
+	std::shared_ptr<const rpc::v_nodes>	cached = cache.find_nodes(routing);
+
+	if ( cached.get() == NULL ) {
+		RPC_EXEC(client.get_handler()->get_nodes(nodes, routing))
+		cached = cache.store_nodes(routing, nodes);
+	}
+
+	VERBOSE_STAT("cache: " << cache.hits() << " hits, " << cache.misses() << " misses")
 
-	print_nodes(print_opts, 0, nodes);
+	Allocation_Counter	allocations;
+	print_nodes(opts, 0, *cached);
+	VERBOSE_STAT("rendering allocations: " << allocations.count())
 
 	return CLI_OK;
 }
@@ -151,7 +182,6 @@ int	cmd_add_node(UNUSED(struct cli_def *cli), const char *command, char *argv[],
 	std::string	key;
 	std::string	value;
 	bool		result;
-	boost::regex	comment("^#.*?$", boost::regex::perl);
 
 	VERBOSE_PRINT(command)
 
@@ -160,25 +190,36 @@ int	cmd_add_node(UNUSED(struct cli_def *cli), const char *command, char *argv[],
 		for ( int i = 0 ; i < argc ; i++ ) {
 			line = argv[i];
 
-			if ( boost::regex_match(line, comment) == true || line.length() == 0 )
-				continue;
-
 			if ( split_line('=',line, key, value) == false ) {
 				return CLI_ERROR_ARG;
 			}
 
-			update_node(key, value, node_to_add);
-		}
-	} else {
-		// Parse std::cin
-		while ( std::cin >> line) {
-			if ( boost::regex_match(line, comment) == true || line.length() == 0 )
+			// Blank line or comment
+			if ( key.empty() == true )
 				continue;
 
-			if ( split_line('=', line, key, value) == false )
+			try {
+				if ( update_node(key, value, node_to_add) == false ) {
+					std::cerr << "Unknown key '" << key << "'" << std::endl;
+					return CLI_ERROR_ARG;
+				}
+			} catch (const std::exception& e) {
+				std::cerr << "Bad value for " << key << ": " << e.what() << std::endl;
 				return CLI_ERROR_ARG;
+			}
+		}
+	} else {
+		// Parse std::cin, only the first block is used
+		Definition_File		input;
+		v_definition_errors	errors;
+		bool				found;
 
-			update_node(key, value, node_to_add);
+		if ( input.open(STDIN_FILENO) == false )
+			return CLI_ERROR_ARG;
+
+		if ( read_node_definition(input, node_to_add, found, errors) == false ) {
+			print_definition_errors(errors);
+			return CLI_ERROR_ARG;
 		}
 	}
 
@@ -186,6 +227,7 @@ int	cmd_add_node(UNUSED(struct cli_def *cli), const char *command, char *argv[],
 
 	if ( result == true ) {
 		std::cout << "success" << std::endl;
+		cache.invalidate(routing.target_node.domain_name);
 	} else {
 		std::cout << "failure" << std::endl;
 	}
@@ -197,9 +239,6 @@ int	cmd_remove_node(UNUSED(struct cli_def *cli), const char *command, char *argv
 	bool		result;
 	rpc::t_node	node_to_remove;
 	std::string key;
-//	boost::regex	spaces("[[:space:]]+", boost::regex::perl);
-//	boost::regex	comment("^#.*?$", boost::regex::perl);
-//	boost::regex	comment_endl("#.*?$", boost::regex::perl);
 
 	VERBOSE_PRINT(command)
 
@@ -218,6 +257,7 @@ int	cmd_remove_node(UNUSED(struct cli_def *cli), const char *command, char *argv
 
 	if ( result == true ) {
 		std::cout << "success" << std::endl;
+		cache.invalidate(routing.target_node.domain_name);
 	} else {
 		std::cout << "failure" << std::endl;
 	}
@@ -233,7 +273,6 @@ int	cmd_add_job(UNUSED(struct cli_def *cli), const char *command, char *argv[],
 	std::string	key;
 	std::string	value;
 	bool		result;
-	boost::regex	comment("^#.*?$", boost::regex::perl);
 
 	VERBOSE_PRINT(command)
 
@@ -245,29 +284,37 @@ int	cmd_add_job(UNUSED(struct cli_def *cli), const char *command, char *argv[],
 		for ( int i = 0 ; i < argc ; i++ ) {
 			line = argv[i];
 
-			if ( boost::regex_match(line, comment) == true || line.length() == 0 )
-				continue;
-
 			if ( split_line('=',line, key, value) == false ) {
 				return CLI_ERROR_ARG;
 			}
 
-			update_job(key, value, job_to_add);
-		}
-	} else {
-		// Parse std::cin
-		while ( std::cin >> line) {
-			if ( boost::regex_match(line, comment) == true || line.length() == 0 )
+			// Blank line or comment
+			if ( key.empty() == true )
 				continue;
 
-			if ( split_line('=', line, key, value) == false )
+			try {
+				if ( update_job(key, value, job_to_add) == false ) {
+					std::cerr << "Unknown key '" << key << "'" << std::endl;
+					return CLI_ERROR_ARG;
+				}
+			} catch (const std::exception& e) {
+				std::cerr << "Bad value for " << key << ": " << e.what() << std::endl;
 				return CLI_ERROR_ARG;
-
-			update_job(key, value, job_to_add);
+			}
 		}
+	} else {
+		// Parse std::cin, only the first block is used
+		Definition_File		input;
+		v_definition_errors	errors;
+		bool				found;
 
-		std::cerr << "Reading the input is not implemented yet!" << std::endl;
-		return CLI_ERROR_ARG;
+		if ( input.open(STDIN_FILENO) == false )
+			return CLI_ERROR_ARG;
+
+		if ( read_job_definition(input, job_to_add, found, errors) == false ) {
+			print_definition_errors(errors);
+			return CLI_ERROR_ARG;
+		}
 	}
 
 	// TODO: change add_job -> add target_node argument
@@ -275,6 +322,7 @@ int	cmd_add_job(UNUSED(struct cli_def *cli), const char *command, char *argv[],
 
 	if ( result == true ) {
 		std::cout << "success" << std::endl;
+		cache.invalidate(routing.target_node.domain_name);
 	} else {
 		std::cout << "failure" << std::endl;
 	}
@@ -287,9 +335,6 @@ int	cmd_remove_job(UNUSED(struct cli_def *cli), const char *command, char *argv[
 	std::string	key;
 	std::string	value;
 	std::string	line;
-//	boost::regex	spaces("[[:space:]]+", boost::regex::perl);
-	boost::regex	comment("^#.*?$", boost::regex::perl);
-//	boost::regex	comment_endl("#.*?$", boost::regex::perl);
 	bool	result;
 
 	VERBOSE_PRINT(command)
@@ -303,22 +348,33 @@ int	cmd_remove_job(UNUSED(struct cli_def *cli), const char *command, char *argv[
 				return CLI_ERROR_ARG;
 			}
 
-			update_job(key, value, job_to_remove);
-		}
-	} else {
-		// Parse std::cin
-		while ( std::cin >> line) {
-			if ( boost::regex_match(line, comment) == true || line.length() == 0 )
+			// Blank line or comment
+			if ( key.empty() == true )
 				continue;
 
-			if ( split_line('=', line, key, value) == false )
+			try {
+				if ( update_job(key, value, job_to_remove) == false ) {
+					std::cerr << "Unknown key '" << key << "'" << std::endl;
+					return CLI_ERROR_ARG;
+				}
+			} catch (const std::exception& e) {
+				std::cerr << "Bad value for " << key << ": " << e.what() << std::endl;
 				return CLI_ERROR_ARG;
-
-			update_job(key, value, job_to_remove);
+			}
 		}
+	} else {
+		// Parse std::cin, only the first block is used
+		Definition_File		input;
+		v_definition_errors	errors;
+		bool				found;
 
-		std::cerr << "Reading the input is not implemented yet!" << std::endl;
-		return CLI_ERROR_ARG;
+		if ( input.open(STDIN_FILENO) == false )
+			return CLI_ERROR_ARG;
+
+		if ( read_job_definition(input, job_to_remove, found, errors) == false ) {
+			print_definition_errors(errors);
+			return CLI_ERROR_ARG;
+		}
 	}
 
 	job_to_remove.node_name = routing.target_node.name;
@@ -326,10 +382,12 @@ int	cmd_remove_job(UNUSED(struct cli_def *cli), const char *command, char *argv[
 
 	RPC_EXEC_RESULT_RETURN(client.get_handler()->remove_job(routing, job_to_remove))
 
-	if ( result == true)
+	if ( result == true) {
 		std::cout << "success";
-	else
+		cache.invalidate(routing.target_node.domain_name);
+	} else {
 		std::cout << "failure";
+	}
 
 	std::cout << std::endl;
 
@@ -341,7 +399,6 @@ int	cmd_update_job(UNUSED(struct cli_def *cli), const char *command, char *argv[
 	std::string	line;
 	std::string	key;
 	std::string	value;
-	boost::regex	comment("^#.*?$", boost::regex::perl);
 
 	VERBOSE_PRINT(command)
 
@@ -352,33 +409,115 @@ int	cmd_update_job(UNUSED(struct cli_def *cli), const char *command, char *argv[
 		for ( int i = 0 ; i < argc ; i++ ) {
 			line = argv[i];
 
-			if ( boost::regex_match(line, comment) == true || line.length() == 0 )
-				continue;
-
 			if ( split_line('=',line, key, value) == false ) {
 				return CLI_ERROR_ARG;
 			}
 
-			update_job(key, value, job_to_update);
-		}
-	} else {
-		// Parse std::cin
-		while ( std::cin >> line) {
-			if ( boost::regex_match(line, comment) == true || line.length() == 0 )
+			// Blank line or comment
+			if ( key.empty() == true )
 				continue;
 
-			if ( split_line('=', line, key, value) == false )
+			try {
+				if ( update_job(key, value, job_to_update) == false ) {
+					std::cerr << "Unknown key '" << key << "'" << std::endl;
+					return CLI_ERROR_ARG;
+				}
+			} catch (const std::exception& e) {
+				std::cerr << "Bad value for " << key << ": " << e.what() << std::endl;
 				return CLI_ERROR_ARG;
-
-			update_job(key, value, job_to_update);
+			}
 		}
+	} else {
+		// Parse std::cin, only the first block is used
+		Definition_File		input;
+		v_definition_errors	errors;
+		bool				found;
 
-		std::cerr << "Reading the input is not implemented yet!" << std::endl;
-		return CLI_ERROR_ARG;
+		if ( input.open(STDIN_FILENO) == false )
+			return CLI_ERROR_ARG;
+
+		if ( read_job_definition(input, job_to_update, found, errors) == false ) {
+			print_definition_errors(errors);
+			return CLI_ERROR_ARG;
+		}
 	}
 
 	// TODO: change add_job -> add target_node argument
 	RPC_EXEC(client.get_handler()->update_job(routing, job_to_update))
+	cache.invalidate(routing.target_node.domain_name);
+
+	return CLI_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int	cmd_import_jobs(UNUSED(struct cli_def *cli), const char *command, char *argv[], int argc) {
+	Definition_File		input;
+	size_t				connections = IMPORT_CONNECTIONS;
+	size_t				threads = std::max(1u, boost::thread::hardware_concurrency());
+	std::string			key;
+	std::string			value;
+	s_import_summary	summary;
+
+	VERBOSE_PRINT(command)
+
+	if ( argc < 1 ) {
+		std::cerr << "Needs the definition file's path" << std::endl;
+		return CLI_ERROR_ARG;
+	}
+
+	for ( int i = 1 ; i < argc ; i++ ) {
+		size_t	number = 0;
+
+		if ( split_line('=', argv[i], key, value) == false )
+			return CLI_ERROR_ARG;
+
+		if ( key.compare("connections") != 0 && key.compare("threads") != 0 ) {
+			std::cerr << "Unknown argument '" << key << "'" << std::endl;
+			return CLI_ERROR_ARG;
+		}
+
+		try {
+			number = boost::lexical_cast<size_t>(value);
+		} catch (const boost::bad_lexical_cast& e) {
+			number = 0;
+		}
+
+		if ( number == 0 ) {
+			std::cerr << key << " must be a positive number" << std::endl;
+			return CLI_ERROR_ARG;
+		}
+
+		if ( key.compare("connections") == 0 )
+			connections = number;
+		else
+			threads = number;
+	}
+
+	if ( client.get_handler() == NULL ) {
+		printf("Not connected!\n");
+		return CLI_ERROR;
+	}
+
+	// "-" reads the definitions from stdin
+	if ( input.open(argv[0]) == false )
+		return CLI_ERROR;
+
+	Job_Importer	importer(pool, routing);
+
+	if ( importer.open(connected_hostname, connected_port, connections) == false )
+		return CLI_ERROR;
+
+	importer.import(input, threads);
+	summary = importer.summary();
+
+	if ( summary.added > 0 )
+		cache.invalidate(routing.target_node.domain_name);
+
+	std::cout << "import: " << summary.added << " added, " << summary.failed << " failed, " << summary.invalid << " invalid" << std::endl;
+
+	if ( summary.failed > 0 || summary.invalid > 0 )
+		return CLI_ERROR;
 
 	return CLI_OK;
 }
@@ -396,45 +535,335 @@ int	cmd_update_job_state(UNUSED(struct cli_def *cli), const char *command, char
 	}
 
 	job.name = argv[0];
-	job.state = build_job_state_from_string(argv[1]);
+	if ( job_state_from_string(argv[1], job.state) == false ) {
+		std::cerr << "Unknown state '" << argv[1] << "'" << std::endl;
+		return CLI_ERROR_ARG;
+	}
 
 	RPC_EXEC(client.get_handler()->update_job_state(routing, job))
+	cache.invalidate(routing.target_node.domain_name);
 
 	return CLI_OK;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-int	cmd_get_ready_jobs(UNUSED(struct cli_def *cli), const char *command, UNUSED(char *argv[]), UNUSED(int argc)) {
-	rpc::v_jobs	ready_jobs;
+/**
+ * Ctrl-C stops the watch after the current poll
+ */
+static void	interrupt_watch(UNUSED(int signal)) {
+	watch_interrupted = 1;
+}
+
+int	cmd_watch_jobs(struct cli_def *cli, const char *command, char *argv[], int argc) {
+	struct sigaction	action;
+	struct sigaction	previous_action;
+	int					interval = WATCH_INTERVAL;
+	int					first = 0;
+	int					rc = CLI_OK;
+	std::vector<char*>	printing_argv;
+	std::string			key;
+	std::string			value;
 
 	VERBOSE_PRINT(command)
 
+	if ( argc > 0 && isdigit(argv[0][0]) ) {
+		try {
+			interval = boost::lexical_cast<int>(argv[0]);
+		} catch (const boost::bad_lexical_cast& e) {
+			interval = 0;
+		}
+
+		if ( interval <= 0 ) {
+			std::cerr << "The interval must be a positive number of seconds" << std::endl;
+			return CLI_ERROR_ARG;
+		}
+
+		first = 1;
+	}
+
+	watch_opts = print_opts;
+	watch_remaining = 0;
+
+	// count=<polls> is ours, the other arguments are the printing ones
+	for ( int i = first ; i < argc ; i++ ) {
+		if ( strncmp(argv[i], "count=", 6) != 0 ) {
+			printing_argv.push_back(argv[i]);
+			continue;
+		}
+
+		if ( split_line('=', argv[i], key, value) == false )
+			return CLI_ERROR_ARG;
+
+		try {
+			watch_remaining = boost::lexical_cast<size_t>(value);
+		} catch (const boost::bad_lexical_cast& e) {
+			watch_remaining = 0;
+		}
+
+		if ( watch_remaining == 0 ) {
+			std::cerr << "count must be a positive number" << std::endl;
+			return CLI_ERROR_ARG;
+		}
+	}
+
+	if ( parse_printing_arguments(printing_argv.data(), printing_argv.size(), watch_opts) == false )
+		return CLI_ERROR_ARG;
+
+	// Each print would truncate the file
+	if ( watch_opts.output_file.empty() == false ) {
+		std::cerr << "watch prints to stdout only" << std::endl;
+		return CLI_ERROR_ARG;
+	}
+
+	watch.clear();
+	watch_interrupted = 0;
+
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = interrupt_watch;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGINT, &action, &previous_action);
+
+	cli_regular(cli, watch_jobs_tick);
+	cli_regular_interval(cli, interval);
+	rc = cli_run_regular(cli);
+
+	sigaction(SIGINT, &previous_action, NULL);
+	watch.clear();
+
+	return rc;
+}
+
+int	watch_jobs_tick(UNUSED(struct cli_def *cli)) {
+	rpc::v_jobs		jobs;
+	s_job_changes	changes;
+
+	if ( watch_interrupted != 0 )
+		return CLI_QUIT;
+
+	// Always fresh: the cache is not used
+	RPC_EXEC(client.get_handler()->get_jobs(jobs, routing))
+
+	std::chrono::steady_clock::time_point	start = std::chrono::steady_clock::now();
+	watch.update(jobs, changes);
+	VERBOSE_STAT("watch: " << watch.size() << " jobs compared in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1000 << " ms")
+
+	print_job_changes(watch_opts, changes);
+
+	if ( watch_remaining > 0 && --watch_remaining == 0 )
+		return CLI_QUIT;
+
+	return CLI_OK;
+}
+
+void	print_job_changes(const s_printing_options& opts, const s_job_changes& changes) {
+	const struct {
+		const char*			name;
+		const rpc::v_jobs*	jobs;
+	} groups[] = {
+		{ "added",		&changes.added },
+		{ "changed",	&changes.changed },
+		{ "removed",	&changes.removed }
+	};
+
+	for ( size_t g = 0 ; g < sizeof(groups) / sizeof(groups[0]) ; ++g ) {
+		if ( groups[g].jobs->empty() == true )
+			continue;
+
+		m_kv	header = {
+			{"change", groups[g].name},
+			{"jobs", boost::lexical_cast<std::string>(groups[g].jobs->size())}
+		};
+
+		print_kv(opts, 0, header);
+		print_jobs(opts, 0, *groups[g].jobs);
+	}
+
+	std::cout.flush();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int	cmd_get_ready_jobs(UNUSED(struct cli_def *cli), const char *command, char *argv[], int argc) {
+	rpc::v_jobs			ready_jobs;
+	s_printing_options	opts = print_opts;
+
+	VERBOSE_PRINT(command)
+
+	if ( parse_printing_arguments(argv, argc, opts) == false )
+		return CLI_ERROR_ARG;
+
 	RPC_EXEC(client.get_handler()->get_ready_jobs(ready_jobs, routing))
 
-	print_jobs(print_opts, 0, ready_jobs);
-	std::cout << std::endl;
+	Allocation_Counter	allocations;
+	print_jobs(opts, 0, ready_jobs);
+	VERBOSE_STAT("rendering allocations: " << allocations.count())
 
 	return CLI_OK;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-int	cmd_get_jobs(UNUSED(struct cli_def *cli), const char *command, UNUSED(char *argv[]), UNUSED(int argc)) {
-	rpc::v_jobs	jobs;
+int	cmd_get_jobs(UNUSED(struct cli_def *cli), const char *command, char *argv[], int argc) {
+	rpc::v_jobs			jobs;
+	std::vector<char*>	printing_argv;
+	s_job_query			query;
+	s_printing_options	opts = print_opts;
 
 	VERBOSE_PRINT(command)
 
-	RPC_EXEC(client.get_handler()->get_jobs(jobs, routing))
+	if ( argc > 0 && strcmp(argv[0], "all-nodes") == 0 )
+		return get_domain_jobs(argv + 1, argc - 1);
 
-	print_jobs(print_opts, 0, jobs);
-	std::cout << std::endl;
+	if ( parse_query_arguments(argv, argc, query, printing_argv) == false )
+		return CLI_ERROR_ARG;
+
+	if ( parse_printing_arguments(printing_argv.data(), printing_argv.size(), opts) == false )
+		return CLI_ERROR_ARG;
+
+	std::shared_ptr<const Job_List>	cached = cache.find_jobs(routing);
+
+	if ( cached.get() == NULL ) {
+		RPC_EXEC(client.get_handler()->get_jobs(jobs, routing))
+		cached = cache.store_jobs(routing, jobs);
+	}
+
+	VERBOSE_STAT("cache: " << cache.hits() << " hits, " << cache.misses() << " misses")
+
+	if ( query.empty() == false ) {
+		std::chrono::steady_clock::time_point	start = std::chrono::steady_clock::now();
+
+		// The index is kept with the cached list
+		cached->select(query, jobs);
+		VERBOSE_STAT("query: " << jobs.size() << " of " << cached->size() << " jobs in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1000 << " ms")
+	}
+
+	Allocation_Counter	allocations;
+	print_jobs(opts, 0, query.empty() == true ? cached->jobs() : jobs);
+	VERBOSE_STAT("rendering allocations: " << allocations.count())
 
 	return CLI_OK;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+int	get_domain_jobs(char *argv[], int argc) {
+	rpc::v_nodes		nodes;
+	rpc::v_jobs			jobs;
+	v_node_jobs			results;
+	std::vector<char*>	query_argv;
+	std::vector<char*>	printing_argv;
+	s_job_query			query;
+	s_printing_options	opts = print_opts;
+	size_t				workers = FAN_OUT_WORKERS;
+	size_t				failed = 0;
+	std::string			key;
+	std::string			value;
+
+	// workers=<number> is ours, the other arguments are the printing ones
+	for ( int i = 0 ; i < argc ; i++ ) {
+		if ( strncmp(argv[i], "workers=", 8) != 0 ) {
+			query_argv.push_back(argv[i]);
+			continue;
+		}
+
+		if ( split_line('=', argv[i], key, value) == false )
+			return CLI_ERROR_ARG;
+
+		try {
+			workers = boost::lexical_cast<size_t>(value);
+		} catch (const boost::bad_lexical_cast& e) {
+			workers = 0;
+		}
+
+		if ( workers == 0 ) {
+			std::cerr << "workers must be a positive number" << std::endl;
+			return CLI_ERROR_ARG;
+		}
+	}
+
+	if ( parse_query_arguments(query_argv.data(), query_argv.size(), query, printing_argv) == false )
+		return CLI_ERROR_ARG;
+
+	if ( parse_printing_arguments(printing_argv.data(), printing_argv.size(), opts) == false )
+		return CLI_ERROR_ARG;
+
+	std::shared_ptr<const rpc::v_nodes>	cached = cache.find_nodes(routing);
+
+	if ( cached.get() == NULL ) {
+		RPC_EXEC(client.get_handler()->get_nodes(nodes, routing))
+		cached = cache.store_nodes(routing, nodes);
+	}
+
+	VERBOSE_STAT("cache: " << cache.hits() << " hits, " << cache.misses() << " misses")
+
+	std::chrono::steady_clock::time_point	start = std::chrono::steady_clock::now();
+	Node_Fan_Out	fan_out(pool, routing, connected_port);
+
+	fan_out.get_jobs(*cached, workers, results);
+
+	BOOST_FOREACH(const s_node_jobs& result, results) {
+		if ( result.error.empty() == false )
+			std::cerr << "get_jobs " << result.node.name << ": " << result.error << std::endl;
+
+		VERBOSE_STAT("node " << result.node.name << ": " << result.jobs.size() << " jobs in " << result.seconds * 1000 << " ms")
+	}
+
+	VERBOSE_STAT(cached->size() << " nodes in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1000 << " ms")
+
+	failed = merge_node_jobs(results, jobs);
+
+	if ( query.empty() == false ) {
+		// The merged list is used once: its index too
+		Job_List	merged(jobs);
+
+		merged.select(query, jobs);
+		VERBOSE_STAT("query: " << jobs.size() << " of " << merged.size() << " jobs")
+	}
+
+	Allocation_Counter	allocations;
+	print_jobs(opts, 0, jobs);
+	VERBOSE_STAT("rendering allocations: " << allocations.count())
+
+	if ( failed > 0 )
+		return CLI_ERROR;
+
+	return CLI_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool	parse_query_arguments(char *argv[], int argc, s_job_query& query, std::vector<char*>& others) {
+	bool		in_where = false;
+	std::string	key;
+	std::string	value;
+
+	for ( int i = 0 ; i < argc ; i++ ) {
+		if ( in_where == false && strcmp(argv[i], "where") == 0 ) {
+			in_where = true;
+			continue;
+		}
+
+		// The printing arguments can follow the predicates
+		if ( in_where == false || strchr(argv[i], '=') == NULL || split_line('=', argv[i], key, value) == false || is_query_key(key) == false ) {
+			others.push_back(argv[i]);
+			continue;
+		}
+
+		if ( compile_predicate(key, value, query) == false )
+			return false;
+	}
+
+	if ( in_where == true && query.empty() == true ) {
+		std::cerr << "where needs at least one predicate: state=, node= or name=" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 int	cmd_monitor_failed_jobs(UNUSED(struct cli_def *cli), const char *command, UNUSED(char *argv[]), UNUSED(int argc)) {
 	rpc::integer	result = 0;
 
@@ -468,9 +897,16 @@ int	cmd_get_available_planning_names(UNUSED(struct cli_def *cli), const char *co
 
 	VERBOSE_PRINT(command)
 
-	RPC_EXEC(client.get_handler()->get_available_planning_names(result, routing))
+	std::shared_ptr<const std::vector<std::string> >	cached = cache.find_planning_names(routing);
+
+	if ( cached.get() == NULL ) {
+		RPC_EXEC(client.get_handler()->get_available_planning_names(result, routing))
+		cached = cache.store_planning_names(routing, result);
+	}
+
+	VERBOSE_STAT("cache: " << cache.hits() << " hits, " << cache.misses() << " misses")
 
-	BOOST_FOREACH(std::string name, result) {
+	BOOST_FOREACH(const std::string& name, *cached) {
 		std::cout << name << std::endl;
 	}
 
@@ -517,14 +953,29 @@ int	cmd_connect(struct cli_def *cli, const char *command, char *argv[], int argc
 		port = boost::lexical_cast<int>(argv[2]);
 	}
 
-	// TODO: check the port using a regex "\d" to avoid exceptions from the lexical_cast
-	if ( client.open(argv[1], boost::lexical_cast<int>(port)) == false )
+	// The cache is not keyed by server: its answers belong to the previous one
+	cache.clear();
+
+	// A connection used recently to the same endpoint is reused
+	if ( client.open(argv[1], port, argv[0]) == false )
 		return CLI_ERROR;
 
+	connected_hostname = argv[1];
+	connected_port = port;
+
 	// Updating the node
 	routing.target_node.name = argv[1];
 
-	RPC_EXEC(client.get_handler()->hello(hello_result, routing.target_node))
+	// The pooled connection may know the answer already
+	if ( client.hello() != NULL ) {
+		hello_result = *client.hello();
+	} else {
+		RPC_EXEC(client.get_handler()->hello(hello_result, routing.target_node))
+		client.set_hello(hello_result);
+	}
+
+	s_pool_stats	stats = pool.stats();
+	VERBOSE_STAT("connections: " << stats.opened << " opened, " << stats.reused << " reused, " << stats.checked << " checked, " << stats.dropped << " dropped")
 
 	routing.target_node.domain_name = hello_result.domain;
 	routing.target_node.name = hello_result.name;
@@ -565,16 +1016,22 @@ int	cmd_use(struct cli_def *cli, const char *command, char *argv[], int argc) {
 		}
 	} else {
 		std::vector<std::string> result;
+		std::shared_ptr<const std::vector<std::string> >	cached = cache.find_planning_names(routing);
 
 		// We could create a dedicated RPC function such as "bool planning_exists(planning, routing)"
-		RPC_EXEC(client.get_handler()->get_available_planning_names(result, routing))
+		if ( cached.get() == NULL ) {
+			RPC_EXEC(client.get_handler()->get_available_planning_names(result, routing))
+			cached = cache.store_planning_names(routing, result);
+		}
+
+		VERBOSE_STAT("cache: " << cache.hits() << " hits, " << cache.misses() << " misses")
 
-		if ( result.size() == 0 ) {
+		if ( cached->size() == 0 ) {
 			std::cerr << "No planning available" << std::endl;
 			return CLI_ERROR;
 		}
 
-		if ( std::find(result.begin(), result.end(), argv[0]) != result.end() ) {
+		if ( std::find(cached->begin(), cached->end(), argv[0]) != cached->end() ) {
 			routing.target_node.domain_name = argv[0];
 			routing.calling_node.domain_name = argv[0];
 		} else {
@@ -605,6 +1062,8 @@ int	cmd_close(struct cli_def *cli, const char *command, UNUSED(char *argv[]), UN
 
 	print_kv(print_opts, 0, values);
 
+	cache.clear();
+
 	if ( client.close() == false )
 		return CLI_ERROR;
 
@@ -640,7 +1099,91 @@ int	cmd_hello(UNUSED(struct cli_def *cli), const char *command, UNUSED(char *arg
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void	clear_node(rpc::t_node _return) {
+int	cmd_load(UNUSED(struct cli_def *cli), const char *command, char *argv[], int argc) {
+	s_printing_options	opts = print_opts;
+
+	VERBOSE_PRINT(command)
+
+	if ( argc < 1 ) {
+		std::cerr << "Needs the snapshot's path" << std::endl;
+		return CLI_ERROR_ARG;
+	}
+
+	if ( parse_printing_arguments(argv + 1, argc - 1, opts) == false )
+		return CLI_ERROR_ARG;
+
+	if ( load_snapshots(opts, argv[0]) == false )
+		return CLI_ERROR;
+
+	return CLI_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool	load_snapshots(const s_printing_options& opts, const char* path) {
+	s_printing_options	snapshot_opts = opts;
+	int					fd = STDIN_FILENO;
+	bool				end = false;
+	bool				result = true;
+
+	if ( strcmp(path, "-") != 0 ) {
+		fd = open(path, O_RDONLY);
+		if ( fd < 0 ) {
+			std::cerr << "Cannot open '" << path << "': " << strerror(errno) << std::endl;
+			return false;
+		}
+	}
+
+	{
+		Snapshot_Reader	reader(fd);
+
+		while ( result == true ) {
+			s_snapshot	snapshot;
+
+			result = reader.read(snapshot, end);
+			if ( result == false || end == true )
+				break;
+
+			print_snapshot(snapshot_opts, 0, snapshot);
+
+			// The next snapshots follow the first one in the file
+			snapshot_opts.output_append = true;
+		}
+	}
+
+	if ( fd != STDIN_FILENO )
+		close(fd);
+
+	return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool	parse_printing_arguments(char *argv[], int argc, s_printing_options& opts) {
+	std::string	key;
+	std::string	value;
+
+	for ( int i = 0 ; i < argc ; i++ ) {
+		if ( split_line('=', argv[i], key, value) == false )
+			return false;
+
+		if ( key.compare("fields") == 0 ) {
+			if ( build_job_fields_from_string(value, opts.job_fields) == false )
+				return false;
+		} else if ( key.compare("file") == 0 ) {
+			opts.output_file = value;
+		} else {
+			std::cerr << "Unknown argument '" << key << "'" << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void	clear_node(rpc::t_node& _return) {
 	_return.name.clear();
 	_return.domain_name.clear();
 	_return.jobs.clear();
@@ -693,10 +1236,18 @@ int	main(const int argc, char const* argv[]) {
 			("help,h", "produce help")
 			("verbose,v", "set verbosity on")
 			("non-interactive,", "read stdin as input")
-			("output", boost::program_options::value<std::string>(), "the output format (plain or json)")
+			("output", boost::program_options::value<std::string>(), "the output format (plain, json, ndjson, table, csv, tsv or binary)")
+			("render-threads", boost::program_options::value<size_t>(), "the number of threads used to render the lists")
+			("fields", boost::program_options::value<std::string>(), "the jobs' attributes to print (name,state,cmd_line...)")
+			("column-width", boost::program_options::value<size_t>(), "the maximum width of a table's column")
+			("output-file", boost::program_options::value<std::string>(), "write the results to this file instead of stdout")
+			("load", boost::program_options::value<std::string>(), "print the snapshots of this file (- for stdin) and exit")
 			("domain", boost::program_options::value<std::string>(), "the domain to use")
 			("hostname", boost::program_options::value<std::string>(), "the endpoint")
 			("planning", boost::program_options::value<std::string>(), "the planning to use")
+			("idle-check", boost::program_options::value<size_t>(), "the idle seconds after which a pooled connection is checked by a hello")
+			("no-cache", "always send get_nodes, get_jobs and get_available_planning_names")
+			("cache-ttl", boost::program_options::value<size_t>(), "the number of seconds the answers of the read requests are kept")
 		;
 
 		boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), opts_variables);
@@ -718,19 +1269,61 @@ int	main(const int argc, char const* argv[]) {
 		}
 
 		if ( opts_variables.count("output")) {
-			std::string _output = opts_variables["output"].as<std::string>();
-			if ( _output.compare("plain") == 0 ) {
-				VERBOSE_PRINT("output set to plain")
-				print_opts.output_type = plain;
-			} else {
-				if ( _output.compare("json") == 0 ) {
-					VERBOSE_PRINT("output set to json")
-					print_opts.output_type = json;
-				} else {
-					std::cerr << "bad output format" << std::endl;
-					return EXIT_FAILURE;
-				}
+			if ( build_output_type_from_string(opts_variables["output"].as<std::string>(), print_opts.output_type) == false ) {
+				std::cerr << "bad output format" << std::endl;
+				return EXIT_FAILURE;
 			}
+			VERBOSE_PRINT("output set to " << output_type_to_string(print_opts.output_type))
+		}
+
+		if ( opts_variables.count("render-threads")) {
+			print_opts.render_threads = opts_variables["render-threads"].as<size_t>();
+			if ( print_opts.render_threads == 0 ) {
+				std::cerr << "at least one rendering thread is required" << std::endl;
+				return EXIT_FAILURE;
+			}
+			VERBOSE_PRINT("render-threads set to " << print_opts.render_threads)
+		}
+
+		if ( opts_variables.count("fields")) {
+			if ( build_job_fields_from_string(opts_variables["fields"].as<std::string>(), print_opts.job_fields) == false )
+				return EXIT_FAILURE;
+			VERBOSE_PRINT("fields set to " << opts_variables["fields"].as<std::string>())
+		}
+
+		if ( opts_variables.count("column-width")) {
+			print_opts.column_width = opts_variables["column-width"].as<size_t>();
+			if ( print_opts.column_width == 0 ) {
+				std::cerr << "the column width must be positive" << std::endl;
+				return EXIT_FAILURE;
+			}
+			VERBOSE_PRINT("column-width set to " << print_opts.column_width)
+		}
+
+		if ( opts_variables.count("output-file")) {
+			print_opts.output_file = opts_variables["output-file"].as<std::string>();
+			VERBOSE_PRINT("output-file set to " << print_opts.output_file)
+		}
+
+		if ( opts_variables.count("idle-check")) {
+			pool.set_idle_check(opts_variables["idle-check"].as<size_t>());
+			VERBOSE_PRINT("idle-check set to " << opts_variables["idle-check"].as<size_t>())
+		}
+
+		if ( opts_variables.count("no-cache")) {
+			cache.set_enabled(false);
+			VERBOSE_PRINT("cache disabled")
+		}
+
+		if ( opts_variables.count("cache-ttl")) {
+			cache.set_ttl(opts_variables["cache-ttl"].as<size_t>());
+			VERBOSE_PRINT("cache-ttl set to " << opts_variables["cache-ttl"].as<size_t>())
+		}
+
+		if ( opts_variables.count("load")) {
+			if ( load_snapshots(print_opts, opts_variables["load"].as<std::string>().c_str()) == false )
+				return EXIT_FAILURE;
+			return EXIT_SUCCESS;
 		}
 	}
 
@@ -0,0 +1,224 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: connection_pool.cpp
+ * Description: implements the pool of connections to the nodes
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "connection_pool.h"
+
+Connection_Pool::Connection_Pool(const size_t& max_idle, const size_t& idle_check) : _max_idle(max_idle), _idle_check(std::chrono::seconds(idle_check)) {
+	this->_stats.opened = 0;
+	this->_stats.reused = 0;
+	this->_stats.checked = 0;
+	this->_stats.dropped = 0;
+}
+
+Connection_Pool::~Connection_Pool() {
+	this->clear();
+}
+
+std::unique_ptr<s_connection>	Connection_Pool::acquire(const s_endpoint& endpoint) {
+	std::unique_ptr<s_connection>	connection;
+
+	while ( true ) {
+		{
+			boost::lock_guard<boost::mutex>	lock(this->_mutex);
+
+			// The most recently used matching connection
+			for ( std::list<std::unique_ptr<s_connection> >::reverse_iterator i = this->_idle.rbegin() ; i != this->_idle.rend() ; ++i ) {
+				if ( (*i)->endpoint == endpoint ) {
+					connection = std::move(*i);
+					this->_idle.erase(std::next(i).base());
+					break;
+				}
+			}
+		}
+
+		if ( connection.get() == NULL )
+			break;
+
+		if ( std::chrono::steady_clock::now() - connection->used < this->_idle_check ) {
+			boost::lock_guard<boost::mutex>	lock(this->_mutex);
+			this->_stats.reused++;
+			return connection;
+		}
+
+		if ( this->check(*connection) == true ) {
+			boost::lock_guard<boost::mutex>	lock(this->_mutex);
+			this->_stats.checked++;
+			return connection;
+		}
+
+		// The node or the network went away, try the next one
+		connection->client.close();
+		connection.reset();
+
+		boost::lock_guard<boost::mutex>	lock(this->_mutex);
+		this->_stats.dropped++;
+	}
+
+	connection.reset(new s_connection());
+	connection->endpoint = endpoint;
+
+	if ( connection->client.open(endpoint.hostname.c_str(), endpoint.port) == false )
+		return std::unique_ptr<s_connection>();
+
+	connection->used = std::chrono::steady_clock::now();
+
+	boost::lock_guard<boost::mutex>	lock(this->_mutex);
+	this->_stats.opened++;
+
+	return connection;
+}
+
+void	Connection_Pool::release(std::unique_ptr<s_connection> connection) {
+	std::unique_ptr<s_connection>	oldest;
+
+	if ( connection.get() == NULL )
+		return;
+
+	if ( connection->broken == true ) {
+		this->close(std::move(connection));
+		return;
+	}
+
+	connection->used = std::chrono::steady_clock::now();
+
+	{
+		boost::lock_guard<boost::mutex>	lock(this->_mutex);
+
+		this->_idle.push_back(std::move(connection));
+
+		if ( this->_idle.size() > this->_max_idle ) {
+			oldest = std::move(this->_idle.front());
+			this->_idle.pop_front();
+		}
+	}
+
+	// Closed out of the lock
+	this->close(std::move(oldest));
+}
+
+void	Connection_Pool::close(std::unique_ptr<s_connection> connection) {
+	if ( connection.get() != NULL )
+		connection->client.close();
+}
+
+void	Connection_Pool::clear() {
+	std::list<std::unique_ptr<s_connection> >	idle;
+
+	{
+		boost::lock_guard<boost::mutex>	lock(this->_mutex);
+		idle.swap(this->_idle);
+	}
+
+	BOOST_FOREACH(std::unique_ptr<s_connection>& connection, idle) {
+		this->close(std::move(connection));
+	}
+}
+
+void	Connection_Pool::set_idle_check(const size_t& seconds) {
+	boost::lock_guard<boost::mutex>	lock(this->_mutex);
+	this->_idle_check = std::chrono::seconds(seconds);
+}
+
+s_pool_stats	Connection_Pool::stats() {
+	boost::lock_guard<boost::mutex>	lock(this->_mutex);
+	return this->_stats;
+}
+
+bool	Connection_Pool::check(s_connection& connection) {
+	rpc::t_node	node;
+
+	if ( connection.client.get_handler() == NULL )
+		return false;
+
+	node.name = connection.endpoint.hostname;
+	node.domain_name = connection.endpoint.domain;
+
+	try {
+		connection.client.get_handler()->hello(connection.hello, node);
+	} catch (const std::exception& e) {
+		connection.has_hello = false;
+		return false;
+	}
+
+	connection.has_hello = true;
+	connection.used = std::chrono::steady_clock::now();
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Pooled_Client::Pooled_Client(Connection_Pool& pool) : _pool(pool) {
+}
+
+Pooled_Client::~Pooled_Client() {
+	this->close();
+}
+
+bool	Pooled_Client::open(const std::string& hostname, const int& port, const std::string& domain) {
+	this->close();
+	this->_connection = this->_pool.acquire(s_endpoint(hostname, port, domain));
+
+	if ( this->_connection.get() == NULL ) {
+		std::cerr << "Cannot connect to " << hostname << ":" << port << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool	Pooled_Client::close() {
+	this->_pool.release(std::move(this->_connection));
+	return true;
+}
+
+void	Pooled_Client::set_broken() {
+	if ( this->_connection.get() != NULL )
+		this->_connection->broken = true;
+}
+
+rpc::ows_rpcClient*	Pooled_Client::get_handler() {
+	if ( this->_connection.get() == NULL )
+		return NULL;
+
+	return this->_connection->client.get_handler();
+}
+
+const rpc::t_hello*	Pooled_Client::hello() const {
+	if ( this->_connection.get() == NULL || this->_connection->has_hello == false )
+		return NULL;
+
+	return &this->_connection->hello;
+}
+
+void	Pooled_Client::set_hello(const rpc::t_hello& hello) {
+	if ( this->_connection.get() == NULL )
+		return;
+
+	this->_connection->hello = hello;
+	this->_connection->has_hello = true;
+}
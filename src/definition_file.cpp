@@ -0,0 +1,951 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: definition_file.cpp
+ * Description: implements the reader of the definition files
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "definition_file.h"
+
+/**
+ * The size of the reads when the input cannot be mapped
+ */
+#define DEFINITION_READ_SIZE	65536
+
+/**
+ * @brief The s_definition_chunk struct
+ *
+ * A part of a definition file parsed by one thread
+ */
+struct s_definition_chunk {
+	const char*						begin;
+	const char*						end;
+	size_t							line_number;	// the lines before the chunk
+	s_job_definitions				result;
+
+	// NULL when the chunk is parsed by the calling thread
+	std::unique_ptr<boost::thread>	parser;
+};
+
+Definition_File::Definition_File() : _data(NULL), _size(0), _mapped(false), _position(0), _line_number(0) {
+}
+
+Definition_File::~Definition_File() {
+	this->close();
+}
+
+bool	Definition_File::open(const std::string& path) {
+	int		fd;
+	bool	result;
+
+	if ( path.compare("-") == 0 )
+		return this->open(STDIN_FILENO);
+
+	fd = ::open(path.c_str(), O_RDONLY);
+	if ( fd < 0 ) {
+		std::cerr << "Cannot open '" << path << "': " << strerror(errno) << std::endl;
+		return false;
+	}
+
+	result = this->open(fd);
+	::close(fd);
+
+	return result;
+}
+
+bool	Definition_File::open(const int& fd) {
+	struct stat	st;
+
+	this->close();
+
+	if ( fstat(fd, &st) != 0 ) {
+		std::cerr << "Cannot read the definitions: " << strerror(errno) << std::endl;
+		return false;
+	}
+
+	// The mapping stays valid once the descriptor is closed
+	if ( S_ISREG(st.st_mode) && st.st_size > 0 ) {
+		void*	data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if ( data != MAP_FAILED ) {
+			madvise(data, st.st_size, MADV_SEQUENTIAL);
+			this->_data = static_cast<const char*>(data);
+			this->_size = st.st_size;
+			this->_mapped = true;
+			return true;
+		}
+	}
+
+	// Pipes and terminals: everything is read
+	while ( true ) {
+		size_t	used = this->_buffer.size();
+		ssize_t	got;
+
+		this->_buffer.resize(used + DEFINITION_READ_SIZE);
+		got = read(fd, &this->_buffer[used], DEFINITION_READ_SIZE);
+
+		if ( got < 0 && errno == EINTR ) {
+			this->_buffer.resize(used);
+			continue;
+		}
+
+		if ( got < 0 ) {
+			std::cerr << "Cannot read the definitions: " << strerror(errno) << std::endl;
+			this->_buffer.clear();
+			return false;
+		}
+
+		this->_buffer.resize(used + got);
+
+		if ( got == 0 )
+			break;
+	}
+
+	this->_data = this->_buffer.data();
+	this->_size = this->_buffer.size();
+
+	return true;
+}
+
+void	Definition_File::open(const char* data, const size_t& size, const size_t& line_number) {
+	this->close();
+
+	this->_data = data;
+	this->_size = size;
+	this->_line_number = line_number;
+}
+
+bool	Definition_File::next_line(boost::string_view& line) {
+	const char*	begin = this->_data + this->_position;
+	const char*	end = NULL;
+
+	if ( this->_position >= this->_size )
+		return false;
+
+	end = static_cast<const char*>(memchr(begin, '\n', this->_size - this->_position));
+	if ( end == NULL )
+		end = this->_data + this->_size;
+
+	line = boost::string_view(begin, end - begin);
+	this->_position = end - this->_data + 1;
+	this->_line_number++;
+
+	return true;
+}
+
+size_t	Definition_File::line_number() const {
+	return this->_line_number;
+}
+
+const char*	Definition_File::data() const {
+	return this->_data;
+}
+
+size_t	Definition_File::size() const {
+	return this->_size;
+}
+
+void	Definition_File::close() {
+	if ( this->_mapped == true )
+		munmap(const_cast<char*>(this->_data), this->_size);
+
+	this->_data = NULL;
+	this->_size = 0;
+	this->_mapped = false;
+	this->_buffer.clear();
+	this->_position = 0;
+	this->_line_number = 0;
+}
+
+/**
+ * add_error
+ */
+static void	add_error(v_definition_errors& errors, const size_t& line, const std::string& message) {
+	s_definition_error	e;
+
+	e.line = line;
+	e.message = message;
+	errors.push_back(e);
+}
+
+/**
+ * read_block
+ *
+ * Reads the key=value lines of a block and gives them to update
+ */
+template<typename T, typename Update>
+bool	read_block(Definition_File& file, T& object, bool& found, v_definition_errors& errors, Update update) {
+	boost::string_view	line;
+	boost::string_view	key_view;
+	boost::string_view	value_view;
+	const char*			error = NULL;
+	std::string			key;
+	std::string			value;
+	bool				valid = true;
+
+	found = false;
+
+	while ( file.next_line(line) == true ) {
+		if ( split_line('=', line, key_view, value_view, error) == false ) {
+			add_error(errors, file.line_number(), error);
+			found = true;
+			valid = false;
+			continue;
+		}
+
+		if ( key_view.empty() == true ) {
+			// A blank line ends the block, a comment does not
+			if ( found == true && trim(line.data(), line.data() + line.size()).empty() == true )
+				break;
+			continue;
+		}
+
+		found = true;
+		key.assign(key_view.data(), key_view.size());
+		value.assign(value_view.data(), value_view.size());
+
+		try {
+			if ( update(key, value, object) == false ) {
+				add_error(errors, file.line_number(), "Unknown key '" + key + "'");
+				valid = false;
+			}
+		} catch (const std::exception& e) {
+			add_error(errors, file.line_number(), "Bad value for " + key + ": " + e.what());
+			valid = false;
+		}
+	}
+
+	return valid;
+}
+
+bool	read_job_block(Definition_File& file, rpc::t_job& job, bool& found, v_definition_errors& errors, Hhmm_Cache* cache) {
+	return read_block(file, job, found, errors, boost::bind(update_job, boost::placeholders::_1, boost::placeholders::_2, boost::placeholders::_3, cache));
+}
+
+bool	read_node_block(Definition_File& file, rpc::t_node& node, bool& found, v_definition_errors& errors) {
+	return read_block(file, node, found, errors, update_node);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//	JSON
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * The JSON readers return false on a syntax error: the rest of the document
+ * cannot be read. A bad value is added to the errors, it makes its object
+ * invalid and the reading goes on.
+ */
+
+/**
+ * json_string
+ *
+ * @param	error	set if the value is not a string, it is skipped
+ */
+static bool	json_string(Json_Reader& reader, std::string& value, std::string& error) {
+	if ( reader.peek() != '"' ) {
+		error = "a string is expected";
+		return reader.skip_value();
+	}
+
+	return reader.read_string(value);
+}
+
+/**
+ * json_integer
+ *
+ * @param	error	set if the value is not a number, it is skipped
+ */
+static bool	json_integer(Json_Reader& reader, rpc::integer& value, std::string& error) {
+	char	c = reader.peek();
+	int64_t	v = 0;
+
+	if ( c != '-' && ( c < '0' || c > '9' ) ) {
+		error = "an integer is expected";
+		return reader.skip_value();
+	}
+
+	if ( reader.read_integer(v) == false )
+		return false;
+
+	value = v;
+	return true;
+}
+
+/**
+ * json_strings
+ *
+ * Reads an array of strings
+ */
+static bool	json_strings(Json_Reader& reader, std::vector<std::string>& values, std::string& error) {
+	bool	more = true;
+
+	if ( reader.peek() != '[' ) {
+		error = "an array of strings is expected";
+		return reader.skip_value();
+	}
+
+	values.clear();
+
+	if ( reader.begin_array() == false )
+		return false;
+
+	while ( reader.next_item(more) == true && more == true ) {
+		values.push_back(std::string());
+
+		if ( json_string(reader, values.back(), error) == false )
+			return false;
+	}
+
+	return *reader.error() == '\0';
+}
+
+/**
+ * json_recovery_type
+ *
+ * Reads a {"short_label", "label", "action"} object
+ */
+static bool	json_recovery_type(Json_Reader& reader, rpc::t_recovery_type& recovery_type, std::string& error) {
+	boost::string_view	key;
+	std::string			text;
+	bool				more = true;
+
+	if ( reader.peek() != '{' ) {
+		error = "an object or a string is expected";
+		return reader.skip_value();
+	}
+
+	if ( reader.begin_object() == false )
+		return false;
+
+	while ( reader.next_member(key, more) == true && more == true ) {
+		bool	read = true;
+
+		switch ( find_attribute(key) ) {
+			case ATTRIBUTE_SHORT_LABEL:
+				read = json_string(reader, recovery_type.short_label, error);
+				break;
+			case ATTRIBUTE_LABEL:
+				read = json_string(reader, recovery_type.label, error);
+				break;
+			case ATTRIBUTE_ACTION:
+				read = json_string(reader, text, error);
+				if ( read == true && error.empty() == true && rectype_action_from_string(text, recovery_type.action) == false )
+					error = "unknown recovery action '" + text + "'";
+				break;
+			default:
+				error = "unknown key '" + key.to_string() + "'";
+				read = reader.skip_value();
+		}
+
+		if ( read == false )
+			return false;
+	}
+
+	return *reader.error() == '\0';
+}
+
+/**
+ * json_time_constraints
+ *
+ * Reads an array of {"type", "value"} objects: the value is a unix time or
+ * a hh:mm string
+ */
+static bool	json_time_constraints(Json_Reader& reader, rpc::v_time_constraints& tcs, std::string& error, Hhmm_Cache* cache) {
+	boost::string_view	key;
+	boost::string_view	text;
+	bool				more = true;
+	bool				members = true;
+
+	if ( reader.peek() != '[' ) {
+		error = "an array or a string is expected";
+		return reader.skip_value();
+	}
+
+	tcs.clear();
+
+	if ( reader.begin_array() == false )
+		return false;
+
+	while ( reader.next_item(more) == true && more == true ) {
+		rpc::t_time_constraint	tc;
+		int						minutes = 0;
+		bool					read = true;
+
+		if ( reader.peek() != '{' ) {
+			error = "an object is expected";
+			if ( reader.skip_value() == false )
+				return false;
+			continue;
+		}
+
+		if ( reader.begin_object() == false )
+			return false;
+
+		while ( reader.next_member(key, members) == true && members == true ) {
+			switch ( find_attribute(key) ) {
+				case ATTRIBUTE_TYPE:
+					if ( reader.peek() != '"' ) {
+						error = "the type must be a string";
+						read = reader.skip_value();
+					} else if ( ( read = reader.read_string(text) ) == true && time_constraint_type_from_string(text, tc.type) == false ) {
+						error = "unknown time constraint type '" + text.to_string() + "'";
+					}
+					break;
+				case ATTRIBUTE_VALUE:
+					if ( reader.peek() != '"' ) {
+						read = json_integer(reader, tc.value, error);
+					} else if ( ( read = reader.read_string(text) ) == true ) {
+						if ( parse_hhmm(text, minutes) == false )
+							error = "bad time '" + text.to_string() + "', expected hhmm or hh:mm";
+						else
+							tc.value = cache == NULL ? resolve_hhmm(minutes) : cache->resolve(minutes);
+					}
+					break;
+				default:
+					error = "unknown key '" + key.to_string() + "'";
+					read = reader.skip_value();
+			}
+
+			if ( read == false )
+				return false;
+		}
+
+		if ( *reader.error() != '\0' )
+			return false;
+
+		tcs.push_back(tc);
+	}
+
+	return *reader.error() == '\0';
+}
+
+bool	read_json_job(Json_Reader& reader, rpc::t_job& job, bool& valid, v_definition_errors& errors, Hhmm_Cache* cache) {
+	boost::string_view	key;
+	std::string			name;
+	std::string			text;
+	bool				more = true;
+
+	valid = true;
+
+	if ( reader.begin_object() == false )
+		return false;
+
+	while ( reader.next_member(key, more) == true && more == true ) {
+		e_attribute	attribute = find_attribute(key);
+		size_t		line = reader.line_number();
+		std::string	error;
+		bool		read = true;
+
+		name.assign(key.data(), key.size());
+
+		try {
+			switch ( attribute ) {
+				case ATTRIBUTE_NAME:
+					read = json_string(reader, job.name, error);
+					break;
+				case ATTRIBUTE_CMD_LINE:
+					read = json_string(reader, job.cmd_line, error);
+					break;
+				case ATTRIBUTE_NODE_NAME:
+					read = json_string(reader, job.node_name, error);
+					break;
+				case ATTRIBUTE_DOMAIN:
+				case ATTRIBUTE_DOMAIN_NAME:
+					// The job belongs to the connected domain
+					read = reader.skip_value();
+					break;
+				case ATTRIBUTE_STATE:
+					read = json_string(reader, text, error);
+					if ( read == true && error.empty() == true && job_state_from_string(text, job.state) == false )
+						error = "unknown state '" + text + "'";
+					break;
+				case ATTRIBUTE_WEIGHT:
+					read = json_integer(reader, job.weight, error);
+					break;
+				case ATTRIBUTE_RETURN_CODE:
+					read = json_integer(reader, job.return_code, error);
+					break;
+				case ATTRIBUTE_START_TIME:
+					read = json_integer(reader, job.start_time, error);
+					break;
+				case ATTRIBUTE_STOP_TIME:
+					read = json_integer(reader, job.stop_time, error);
+					break;
+				case ATTRIBUTE_NXT:
+				case ATTRIBUTE_PRV:
+				case ATTRIBUTE_RECOVERY_TYPE:
+				case ATTRIBUTE_TIME_CONSTRAINTS:
+					// The strings have the same syntax as the key=value definitions
+					if ( reader.peek() == '"' ) {
+						read = reader.read_string(text);
+						if ( read == true && attribute == ATTRIBUTE_RECOVERY_TYPE && text.find(':') == std::string::npos ) {
+							// Only the action, as printed by get jobs
+							if ( rectype_action_from_string(text, job.recovery_type.action) == false )
+								error = "unknown recovery action '" + text + "'";
+						} else if ( read == true ) {
+							update_job(name, text, job, cache);
+						}
+					} else if ( attribute == ATTRIBUTE_NXT ) {
+						read = json_strings(reader, job.nxt, error);
+					} else if ( attribute == ATTRIBUTE_PRV ) {
+						read = json_strings(reader, job.prv, error);
+					} else if ( attribute == ATTRIBUTE_RECOVERY_TYPE ) {
+						read = json_recovery_type(reader, job.recovery_type, error);
+					} else {
+						read = json_time_constraints(reader, job.time_constraints, error, cache);
+					}
+					break;
+				default:
+					add_error(errors, line, "Unknown key '" + name + "'");
+					valid = false;
+					read = reader.skip_value();
+			}
+		} catch (const std::exception& e) {
+			error = e.what();
+		}
+
+		if ( read == false )
+			return false;
+
+		if ( error.empty() == false ) {
+			add_error(errors, line, "Bad value for " + name + ": " + error);
+			valid = false;
+		}
+	}
+
+	// The name can follow the time constraints
+	BOOST_FOREACH(rpc::t_time_constraint& tc, job.time_constraints) {
+		tc.job_name = job.name;
+	}
+
+	return *reader.error() == '\0';
+}
+
+/**
+ * json_resources
+ *
+ * Reads an array of {"name", "current_value", "initial_value"} objects
+ */
+static bool	json_resources(Json_Reader& reader, rpc::v_resources& resources, std::string& error) {
+	boost::string_view	key;
+	bool				more = true;
+	bool				members = true;
+
+	if ( reader.peek() != '[' ) {
+		error = "an array is expected";
+		return reader.skip_value();
+	}
+
+	resources.clear();
+
+	if ( reader.begin_array() == false )
+		return false;
+
+	while ( reader.next_item(more) == true && more == true ) {
+		rpc::t_resource	resource;
+		bool			read = true;
+
+		if ( reader.begin_object() == false )
+			return false;
+
+		while ( reader.next_member(key, members) == true && members == true ) {
+			switch ( find_attribute(key) ) {
+				case ATTRIBUTE_NAME:
+					read = json_string(reader, resource.name, error);
+					break;
+				case ATTRIBUTE_CURRENT_VALUE:
+					read = json_integer(reader, resource.current_value, error);
+					break;
+				case ATTRIBUTE_INITIAL_VALUE:
+					read = json_integer(reader, resource.initial_value, error);
+					break;
+				default:
+					error = "unknown key '" + key.to_string() + "'";
+					read = reader.skip_value();
+			}
+
+			if ( read == false )
+				return false;
+		}
+
+		if ( *reader.error() != '\0' )
+			return false;
+
+		resources.push_back(resource);
+	}
+
+	return *reader.error() == '\0';
+}
+
+bool	read_json_node(Json_Reader& reader, rpc::t_node& node, bool& valid, v_definition_errors& errors, Hhmm_Cache* cache) {
+	boost::string_view	key;
+	std::string			name;
+	bool				more = true;
+	bool				items = true;
+
+	valid = true;
+
+	if ( reader.begin_object() == false )
+		return false;
+
+	while ( reader.next_member(key, more) == true && more == true ) {
+		size_t		line = reader.line_number();
+		std::string	error;
+		bool		read = true;
+		bool		job_valid = true;
+
+		name.assign(key.data(), key.size());
+
+		switch ( find_attribute(key) ) {
+			case ATTRIBUTE_NAME:
+				read = json_string(reader, node.name, error);
+				break;
+			case ATTRIBUTE_DOMAIN:
+			case ATTRIBUTE_DOMAIN_NAME:
+				read = json_string(reader, node.domain_name, error);
+				break;
+			case ATTRIBUTE_WEIGHT:
+				read = json_integer(reader, node.weight, error);
+				break;
+			case ATTRIBUTE_RESOURCES:
+				read = json_resources(reader, node.resources, error);
+				break;
+			case ATTRIBUTE_JOBS:
+				if ( reader.peek() != '[' ) {
+					error = "an array is expected";
+					read = reader.skip_value();
+					break;
+				}
+
+				node.jobs.clear();
+				read = reader.begin_array();
+
+				while ( read == true && reader.next_item(items) == true && items == true ) {
+					node.jobs.push_back(rpc::t_job());
+					read = read_json_job(reader, node.jobs.back(), job_valid, errors, cache);
+					if ( job_valid == false )
+						valid = false;
+				}
+
+				read = read == true && *reader.error() == '\0';
+				break;
+			default:
+				error = "unknown key";
+				read = reader.skip_value();
+		}
+
+		if ( read == false )
+			return false;
+
+		if ( error.empty() == false ) {
+			add_error(errors, line, "Bad value for " + name + ": " + error);
+			valid = false;
+		}
+	}
+
+	// The jobs belong to their node's domain
+	BOOST_FOREACH(rpc::t_job& job, node.jobs) {
+		job.domain = node.domain_name;
+	}
+
+	return *reader.error() == '\0';
+}
+
+bool	is_json(const Definition_File& file) {
+	const char*	c = file.data();
+	const char*	end = file.data() + file.size();
+
+	while ( c < end && ( *c == ' ' || *c == '\t' || *c == '\r' || *c == '\n' ) )
+		++c;
+
+	return c < end && ( *c == '{' || *c == '[' );
+}
+
+/**
+ * read_json_definition
+ *
+ * Reads a job and adds it to the result
+ *
+ * @return false on a syntax error
+ */
+static bool	read_json_definition(Json_Reader& reader, const std::string& domain, Hhmm_Cache& cache, s_job_definitions& result, const job_definitions_handler& handler) {
+	rpc::t_job	job;
+	bool		valid = true;
+
+	// By default the job belongs to the connected domain
+	job.domain = domain;
+
+	if ( read_json_job(reader, job, valid, result.errors, &cache) == false )
+		return false;
+
+	if ( valid == true )
+		result.jobs.push_back(std::move(job));
+	else
+		result.invalid++;
+
+	// Invalid objects fill the batch too: the errors are not kept until the end
+	if ( result.jobs.size() + result.errors.size() >= DEFINITION_JSON_BATCH ) {
+		handler(result);
+		result.jobs.clear();
+		result.invalid = 0;
+		result.errors.clear();
+	}
+
+	return true;
+}
+
+/**
+ * append_definitions
+ *
+ * A job_definitions_handler merging the parts into result
+ */
+static void	append_definitions(s_job_definitions* result, s_job_definitions& part) {
+	if ( result->jobs.empty() == true )
+		result->jobs.swap(part.jobs);
+	else
+		result->jobs.insert(result->jobs.end(), std::make_move_iterator(part.jobs.begin()), std::make_move_iterator(part.jobs.end()));
+
+	result->invalid += part.invalid;
+	result->errors.insert(result->errors.end(), part.errors.begin(), part.errors.end());
+}
+
+void	read_json_definitions(const Definition_File& file, const std::string& domain, s_job_definitions& result) {
+	result.jobs.clear();
+	result.invalid = 0;
+	result.errors.clear();
+
+	read_json_definitions(file, domain, boost::bind(append_definitions, &result, boost::placeholders::_1));
+}
+
+void	read_json_definitions(const Definition_File& file, const std::string& domain, const job_definitions_handler& handler) {
+	Json_Reader			reader(file.data(), file.size(), file.line_number());
+	Hhmm_Cache			cache;
+	s_job_definitions	batch;
+	bool				read = true;
+	bool				more = true;
+
+	batch.invalid = 0;
+
+	// Objects, arrays of objects or both, one after the other
+	while ( read == true && reader.peek() != '\0' ) {
+		if ( reader.peek() != '[' ) {
+			read = read_json_definition(reader, domain, cache, batch, handler);
+			continue;
+		}
+
+		read = reader.begin_array();
+
+		while ( read == true && reader.next_item(more) == true && more == true ) {
+			read = read_json_definition(reader, domain, cache, batch, handler);
+		}
+
+		read = read == true && *reader.error() == '\0';
+	}
+
+	if ( read == false ) {
+		add_error(batch.errors, reader.line_number(), reader.error());
+		batch.invalid++;
+	}
+
+	handler(batch);
+}
+
+/**
+ * read_first_json
+ *
+ * Reads the first object of a JSON document, or the first item of an array
+ *
+ * @param	read_object	read_json_job or read_json_node
+ */
+template<typename T>
+static bool	read_first_json(Definition_File& file, T& object, bool& found, v_definition_errors& errors,
+	bool (*read_object)(Json_Reader&, T&, bool&, v_definition_errors&, Hhmm_Cache*)) {
+	Json_Reader	reader(file.data(), file.size(), file.line_number());
+	bool		valid = true;
+	bool		more = true;
+
+	found = false;
+
+	if ( reader.peek() == '[' && ( reader.begin_array() == false || reader.next_item(more) == false ) ) {
+		add_error(errors, reader.line_number(), reader.error());
+		return false;
+	}
+
+	if ( more == false )
+		return true;
+
+	found = true;
+
+	if ( read_object(reader, object, valid, errors, NULL) == false ) {
+		add_error(errors, reader.line_number(), reader.error());
+		return false;
+	}
+
+	return valid;
+}
+
+bool	read_job_definition(Definition_File& file, rpc::t_job& job, bool& found, v_definition_errors& errors) {
+	if ( is_json(file) == true )
+		return read_first_json(file, job, found, errors, read_json_job);
+
+	return read_job_block(file, job, found, errors);
+}
+
+bool	read_node_definition(Definition_File& file, rpc::t_node& node, bool& found, v_definition_errors& errors) {
+	if ( is_json(file) == true )
+		return read_first_json(file, node, found, errors, read_json_node);
+
+	return read_node_block(file, node, found, errors);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * next_block_boundary
+ *
+ * @return	the beginning of the line following the first blank line found
+ *			after position, or end
+ */
+static const char*	next_block_boundary(const char* position, const char* end) {
+	// Move to the beginning of the next line
+	position = static_cast<const char*>(memchr(position, '\n', end - position));
+
+	while ( position != NULL ) {
+		const char*	line = position + 1;
+
+		position = static_cast<const char*>(memchr(line, '\n', end - line));
+
+		if ( position != NULL && trim(line, position).empty() == true )
+			return position + 1;
+	}
+
+	return end;
+}
+
+/**
+ * read_chunk
+ *
+ * A parsing thread: reads the job blocks of its chunk
+ */
+static void	read_chunk(s_definition_chunk* chunk, const std::string* domain) {
+	Definition_File	file;
+	Hhmm_Cache		cache;
+	bool			found = true;
+
+	file.open(chunk->begin, chunk->end - chunk->begin, chunk->line_number);
+
+	while ( found == true ) {
+		rpc::t_job	job;
+
+		// By default the job belongs to the connected domain
+		job.domain = *domain;
+
+		if ( read_job_block(file, job, found, chunk->result.errors, &cache) == false ) {
+			chunk->result.invalid++;
+			continue;
+		}
+
+		if ( found == true )
+			chunk->result.jobs.push_back(std::move(job));
+	}
+}
+
+void	read_job_definitions(const Definition_File& file, const std::string& domain, const size_t& threads, const job_definitions_handler& handler,
+	const size_t& chunk_size) {
+	std::deque<std::unique_ptr<s_definition_chunk> >	chunks;
+	const char*											begin = file.data();
+	const char*											end = file.data() + file.size();
+	size_t												line_number = file.line_number();
+
+	if ( is_json(file) == true ) {
+		read_json_definitions(file, domain, handler);
+		return;
+	}
+
+	try {
+		while ( begin < end || chunks.empty() == false ) {
+			// Keep up to threads chunks parsed ahead of the handler
+			while ( begin < end && chunks.size() < std::max<size_t>(1, threads) ) {
+				std::unique_ptr<s_definition_chunk>	chunk(new s_definition_chunk());
+
+				// Cut the file at blank lines
+				chunk->begin = begin;
+				chunk->end = static_cast<size_t>(end - begin) > chunk_size ? next_block_boundary(begin + chunk_size, end) : end;
+				chunk->line_number = line_number;
+				chunk->result.invalid = 0;
+
+				line_number += std::count(chunk->begin, chunk->end, '\n');
+				begin = chunk->end;
+
+				// Owned by the deque before its parser starts
+				chunks.push_back(std::move(chunk));
+
+				if ( threads > 1 )
+					chunks.back()->parser.reset(new boost::thread(boost::bind(read_chunk, chunks.back().get(), &domain)));
+				else
+					read_chunk(chunks.back().get(), &domain);
+			}
+
+			// Handed over in file order
+			if ( chunks.front()->parser.get() != NULL )
+				chunks.front()->parser->join();
+
+			handler(chunks.front()->result);
+			chunks.pop_front();
+		}
+	} catch (...) {
+		// The parsers write into their chunks: they must stop before the chunks are freed
+		BOOST_FOREACH(std::unique_ptr<s_definition_chunk>& chunk, chunks) {
+			if ( chunk->parser.get() != NULL && chunk->parser->joinable() == true )
+				chunk->parser->join();
+		}
+
+		throw;
+	}
+}
+
+void	read_job_definitions(const Definition_File& file, const std::string& domain, const size_t& threads, s_job_definitions& result,
+	const size_t& chunk_size) {
+	result.jobs.clear();
+	result.invalid = 0;
+	result.errors.clear();
+
+	read_job_definitions(file, domain, threads, boost::bind(append_definitions, &result, boost::placeholders::_1), chunk_size);
+}
+
+void	print_definition_errors(const v_definition_errors& errors) {
+	BOOST_FOREACH(const s_definition_error& e, errors) {
+		std::cerr << "line " << e.line << ": " << e.message << std::endl;
+	}
+}
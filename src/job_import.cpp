@@ -0,0 +1,238 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: job_import.cpp
+ * Description: implements the bulk import of jobs
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "job_import.h"
+
+Job_Importer::Job_Importer(Connection_Pool& pool, const rpc::t_routing_data& routing) : _pool(pool), _routing(routing), _queue_size(0), _closed(false), _senders_left(0) {
+	this->_summary.added = 0;
+	this->_summary.failed = 0;
+	this->_summary.invalid = 0;
+}
+
+Job_Importer::~Job_Importer() {
+	this->finish();
+}
+
+bool	Job_Importer::open(const std::string& hostname, const int& port, const size_t& connections) {
+	this->_endpoint = s_endpoint(hostname, port, this->_routing.target_node.domain_name);
+
+	for ( size_t i = 0 ; i < connections ; ++i ) {
+		std::unique_ptr<s_connection>	connection = this->_pool.acquire(this->_endpoint);
+
+		if ( connection.get() == NULL ) {
+			std::cerr << "Cannot open the connection " << i + 1 << " to " << hostname << ":" << port << std::endl;
+			continue;
+		}
+
+		this->_connections.push_back(std::move(connection));
+	}
+
+	if ( this->_connections.empty() == true )
+		return false;
+
+	this->_queue_size = IMPORT_QUEUE_SIZE * this->_connections.size();
+	this->_senders_left = this->_connections.size();
+
+	for ( size_t i = 0 ; i < this->_connections.size() ; ++i ) {
+		this->_senders.create_thread(boost::bind(&Job_Importer::send, this, i));
+	}
+
+	return true;
+}
+
+void	Job_Importer::import(const Definition_File& input, const size_t& threads) {
+	read_job_definitions(input, this->_routing.target_node.domain_name, threads, boost::bind(&Job_Importer::push_definitions, this, boost::placeholders::_1));
+
+	this->finish();
+}
+
+void	Job_Importer::push_definitions(s_job_definitions& definitions) {
+	print_definition_errors(definitions.errors);
+
+	{
+		boost::lock_guard<boost::mutex>	lock(this->_mutex);
+		this->_summary.invalid += definitions.invalid;
+	}
+
+	BOOST_FOREACH(rpc::t_job& job, definitions.jobs) {
+		this->push(std::move(job));
+	}
+}
+
+s_import_summary	Job_Importer::summary() {
+	boost::lock_guard<boost::mutex>	lock(this->_mutex);
+
+	return this->_summary;
+}
+
+void	Job_Importer::push(rpc::t_job&& job) {
+	boost::unique_lock<boost::mutex>	lock(this->_mutex);
+
+	while ( this->_queue.size() >= this->_queue_size && this->_senders_left > 0 )
+		this->_not_full.wait(lock);
+
+	// Every connection is lost
+	if ( this->_senders_left == 0 ) {
+		this->_summary.failed++;
+		return;
+	}
+
+	this->_queue.push_back(std::move(job));
+	this->_not_empty.notify_one();
+}
+
+void	Job_Importer::finish() {
+	{
+		boost::lock_guard<boost::mutex>	lock(this->_mutex);
+
+		if ( this->_closed == true )
+			return;
+
+		this->_closed = true;
+		this->_not_empty.notify_all();
+	}
+
+	this->_senders.join_all();
+
+	BOOST_FOREACH(std::unique_ptr<s_connection>& connection, this->_connections) {
+		this->_pool.release(std::move(connection));
+	}
+
+	this->_connections.clear();
+}
+
+bool	Job_Importer::pop(rpc::t_job& job) {
+	boost::unique_lock<boost::mutex>	lock(this->_mutex);
+
+	while ( this->_queue.empty() == true && this->_closed == false )
+		this->_not_empty.wait(lock);
+
+	if ( this->_queue.empty() == true )
+		return false;
+
+	std::swap(job, this->_queue.front());
+	this->_queue.pop_front();
+	this->_not_full.notify_one();
+
+	return true;
+}
+
+void	Job_Importer::requeue(rpc::t_job& job) {
+	boost::lock_guard<boost::mutex>	lock(this->_mutex);
+
+	this->_queue.push_front(rpc::t_job());
+	std::swap(job, this->_queue.front());
+	this->_not_empty.notify_one();
+}
+
+void	Job_Importer::count(const bool& added) {
+	boost::lock_guard<boost::mutex>	lock(this->_mutex);
+
+	if ( added == true )
+		this->_summary.added++;
+	else
+		this->_summary.failed++;
+}
+
+bool	Job_Importer::reconnect(const size_t& slot) {
+	// Broken: the pool closes it
+	this->_pool.release(std::move(this->_connections[slot]));
+	this->_connections[slot] = this->_pool.acquire(this->_endpoint);
+
+	if ( this->_connections[slot].get() == NULL ) {
+		std::cerr << "Cannot reopen a connection to " << this->_endpoint.hostname << ":" << this->_endpoint.port << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+void	Job_Importer::leave() {
+	boost::lock_guard<boost::mutex>	lock(this->_mutex);
+
+	if ( --this->_senders_left > 0 || this->_queue.empty() == true )
+		return;
+
+	std::cerr << "No connection left: " << this->_queue.size() << " queued jobs are not sent" << std::endl;
+
+	this->_summary.failed += this->_queue.size();
+	this->_queue.clear();
+
+	// push counts the next jobs as failed
+	this->_not_full.notify_all();
+}
+
+void	Job_Importer::send(const size_t& slot) {
+	rpc::t_job	job;
+
+	while ( this->pop(job) == true ) {
+		size_t	attempts = 0;
+		bool	sent = false;
+		bool	added = false;
+
+		while ( sent == false ) {
+			try {
+				added = this->_connections[slot]->client.get_handler()->add_job(this->_routing, job);
+				if ( added == false )
+					std::cerr << "add_job " << job.name << ": refused" << std::endl;
+				sent = true;
+			} catch (const rpc::ex_routing& e) {
+				std::cerr << "add_job " << job.name << ": ex::routing: " << e.msg << std::endl;
+				sent = true;
+			} catch (const rpc::ex_node& e) {
+				std::cerr << "add_job " << job.name << ": ex::node: " << e.msg << std::endl;
+				sent = true;
+			} catch (const rpc::ex_job& e) {
+				std::cerr << "add_job " << job.name << ": ex::job: " << e.msg << std::endl;
+				sent = true;
+			} catch (const rpc::ex_processing& e) {
+				std::cerr << "add_job " << job.name << ": ex_processing: " << e.msg << std::endl;
+				sent = true;
+			} catch (const std::exception& e) {
+				std::cerr << "add_job " << job.name << ": " << e.what() << std::endl;
+				this->_connections[slot]->broken = true;
+
+				// The job itself may break the connections: it is not sent forever
+				sent = ++attempts == IMPORT_ATTEMPTS;
+			}
+
+			if ( this->_connections[slot]->broken == true && this->reconnect(slot) == false ) {
+				if ( sent == true )
+					this->count(added);
+				else
+					this->requeue(job);
+
+				this->leave();
+				return;
+			}
+		}
+
+		this->count(added);
+	}
+
+	this->leave();
+}
@@ -0,0 +1,58 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: job_list.cpp
+ * Description: implements the job lists kept by the cli
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "job_list.h"
+
+Job_List::Job_List(rpc::v_jobs& jobs) : _set(this->_pool) {
+	this->_jobs.swap(jobs);
+}
+
+const rpc::v_jobs&	Job_List::jobs() const {
+	return this->_jobs;
+}
+
+size_t	Job_List::size() const {
+	return this->_jobs.size();
+}
+
+void	Job_List::select(const s_job_query& query, rpc::v_jobs& matches) const {
+	std::vector<size_t>	selected;
+
+	if ( this->_index.get() == NULL ) {
+		this->_set.add(this->_jobs);
+		this->_index.reset(new Job_Index(this->_set));
+	}
+
+	this->_index->select(query, selected);
+
+	matches.clear();
+	matches.reserve(selected.size());
+
+	BOOST_FOREACH(const size_t& position, selected) {
+		matches.push_back(this->_jobs[position]);
+	}
+}
@@ -0,0 +1,167 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: job_query.cpp
+ * Description: implements the filters applied to the fetched jobs
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "job_query.h"
+
+bool	is_query_key(const std::string& key) {
+	return key.compare("state") == 0 || key.compare("node") == 0 || key.compare("node_name") == 0 || key.compare("name") == 0;
+}
+
+bool	compile_predicate(const std::string& key, const std::string& value, s_job_query& query) {
+	std::vector<std::string>	values;
+
+	boost::split(values, value, boost::is_any_of(","));
+
+	BOOST_FOREACH(const std::string& v, values) {
+		if ( key.compare("state") == 0 ) {
+			rpc::e_job_state::type	state;
+
+			if ( job_state_from_string(v, state) == false ) {
+				std::cerr << "Unknown state '" << v << "'" << std::endl;
+				return false;
+			}
+
+			query.states.push_back(state);
+			continue;
+		}
+
+		s_name_pattern	pattern;
+		size_t			star = v.find('*');
+
+		if ( star != std::string::npos && star != v.size() - 1 ) {
+			std::cerr << "Bad pattern '" << v << "': only a trailing '*' is supported" << std::endl;
+			return false;
+		}
+
+		pattern.prefix = star != std::string::npos;
+		pattern.text = v.substr(0, star);
+
+		if ( key.compare("name") == 0 )
+			query.names.push_back(pattern);
+		else
+			query.nodes.push_back(pattern);
+	}
+
+	return true;
+}
+
+Job_Index::Job_Index(const Job_Set& set) : _set(set) {
+	for ( size_t i = 0 ; i < set.size() ; ++i ) {
+		const s_job_record&	job = set.record(i);
+		s_indexed_job		indexed;
+
+		// The views point to the set's pool, which outlives the index
+		indexed.state = job.state;
+		indexed.node_name = set.pool().get(job.node_name);
+		indexed.name = set.pool().get(job.name);
+		indexed.position = i;
+
+		this->_index.insert(indexed);
+	}
+}
+
+void	Job_Index::select(const s_job_query& query, std::vector<size_t>& selected) const {
+	std::vector<size_t>	positions;
+	bool				first = true;
+
+	selected.clear();
+
+	if ( query.empty() == true ) {
+		for ( size_t i = 0 ; i < this->_set.size() ; ++i ) {
+			selected.push_back(i);
+		}
+		return;
+	}
+
+	if ( query.states.empty() == false ) {
+		const t_job_index::index<by_state>::type&	states = this->_index.get<by_state>();
+
+		BOOST_FOREACH(const rpc::e_job_state::type& state, query.states) {
+			std::pair<t_job_index::index<by_state>::type::const_iterator, t_job_index::index<by_state>::type::const_iterator>	range = states.equal_range(state);
+
+			for ( ; range.first != range.second ; ++range.first ) {
+				positions.push_back(range.first->position);
+			}
+		}
+
+		restrict(selected, positions, first);
+	}
+
+	if ( query.nodes.empty() == false ) {
+		select_patterns(this->_index.get<by_node>(), query.nodes, positions);
+		restrict(selected, positions, first);
+	}
+
+	if ( query.names.empty() == false ) {
+		select_patterns(this->_index.get<by_name>(), query.names, positions);
+		restrict(selected, positions, first);
+	}
+}
+
+template<typename Index>
+void	Job_Index::select_patterns(const Index& index, const std::vector<s_name_pattern>& patterns, std::vector<size_t>& positions) {
+	BOOST_FOREACH(const s_name_pattern& pattern, patterns) {
+		boost::string_view				text(pattern.text);
+		typename Index::const_iterator	i;
+
+		if ( pattern.prefix == false ) {
+			std::pair<typename Index::const_iterator, typename Index::const_iterator>	range = index.equal_range(text);
+
+			for ( ; range.first != range.second ; ++range.first ) {
+				positions.push_back(range.first->position);
+			}
+			continue;
+		}
+
+		// The names starting with the prefix follow each other
+		for ( i = index.lower_bound(text) ; i != index.end() ; ++i ) {
+			boost::string_view	key = index.key_extractor()(*i);
+
+			if ( key.substr(0, text.size()) != text )
+				break;
+
+			positions.push_back(i->position);
+		}
+	}
+}
+
+void	Job_Index::restrict(std::vector<size_t>& selected, std::vector<size_t>& positions, bool& first) {
+	std::vector<size_t>	both;
+
+	std::sort(positions.begin(), positions.end());
+	positions.erase(std::unique(positions.begin(), positions.end()), positions.end());
+
+	if ( first == true ) {
+		selected.swap(positions);
+		first = false;
+	} else {
+		std::set_intersection(selected.begin(), selected.end(), positions.begin(), positions.end(), std::back_inserter(both));
+		selected.swap(both);
+	}
+
+	positions.clear();
+}
@@ -0,0 +1,195 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: job_set.cpp
+ * Description: implements the compact set of fetched jobs
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <algorithm>
+
+#include "job_set.h"
+
+Job_Set::Job_Set(String_Pool& pool) : _pool(&pool) {
+}
+
+void	Job_Set::add(const rpc::t_job& job) {
+	s_job_record	record;
+
+	record.name = this->_pool->intern(job.name);
+	record.domain = this->_pool->intern(job.domain);
+	record.node_name = this->_pool->intern(job.node_name);
+	record.cmd_line = this->_pool->intern(job.cmd_line);
+	record.recovery_short_label = this->_pool->intern(job.recovery_type.short_label);
+	record.recovery_label = this->_pool->intern(job.recovery_type.label);
+	record.recovery_action = job.recovery_type.action;
+	record.state = job.state;
+
+	record.nxt = this->intern(job.nxt);
+	record.nxt_count = job.nxt.size();
+	record.prv = this->intern(job.prv);
+	record.prv_count = job.prv.size();
+
+	record.time_constraints = this->_time_constraints.size();
+	record.time_constraints_count = job.time_constraints.size();
+	BOOST_FOREACH(const rpc::t_time_constraint& tc, job.time_constraints) {
+		s_time_constraint_record	tc_record;
+
+		tc_record.type = tc.type;
+		tc_record.value = tc.value;
+		this->_time_constraints.push_back(tc_record);
+	}
+
+	record.return_code = job.return_code;
+	record.start_time = job.start_time;
+	record.stop_time = job.stop_time;
+	record.weight = job.weight;
+
+	this->_jobs.push_back(record);
+}
+
+void	Job_Set::add(const rpc::v_jobs& jobs) {
+	this->_jobs.reserve(this->_jobs.size() + jobs.size());
+
+	BOOST_FOREACH(const rpc::t_job& job, jobs) {
+		this->add(job);
+	}
+}
+
+void	Job_Set::clear() {
+	this->_jobs.clear();
+	this->_links.clear();
+	this->_time_constraints.clear();
+}
+
+size_t	Job_Set::size() const {
+	return this->_jobs.size();
+}
+
+const s_job_record&	Job_Set::record(const size_t& i) const {
+	return this->_jobs[i];
+}
+
+const string_id*	Job_Set::nxt(const s_job_record& job) const {
+	return this->_links.data() + job.nxt;
+}
+
+const string_id*	Job_Set::prv(const s_job_record& job) const {
+	return this->_links.data() + job.prv;
+}
+
+const s_time_constraint_record*	Job_Set::time_constraints(const s_job_record& job) const {
+	return this->_time_constraints.data() + job.time_constraints;
+}
+
+void	Job_Set::get(const size_t& i, rpc::t_job& job) const {
+	const s_job_record&				record = this->_jobs[i];
+	const s_time_constraint_record*	tcs = this->time_constraints(record);
+
+	job.name = this->_pool->get(record.name).to_string();
+	job.domain = this->_pool->get(record.domain).to_string();
+	job.node_name = this->_pool->get(record.node_name).to_string();
+	job.cmd_line = this->_pool->get(record.cmd_line).to_string();
+	job.recovery_type.short_label = this->_pool->get(record.recovery_short_label).to_string();
+	job.recovery_type.label = this->_pool->get(record.recovery_label).to_string();
+	job.recovery_type.action = record.recovery_action;
+	job.state = record.state;
+
+	this->names(record.nxt, record.nxt_count, job.nxt);
+	this->names(record.prv, record.prv_count, job.prv);
+
+	job.time_constraints.resize(record.time_constraints_count);
+	for ( uint32_t t = 0 ; t < record.time_constraints_count ; ++t ) {
+		job.time_constraints[t].job_name = job.name;
+		job.time_constraints[t].type = tcs[t].type;
+		job.time_constraints[t].value = tcs[t].value;
+	}
+
+	job.return_code = record.return_code;
+	job.start_time = record.start_time;
+	job.stop_time = record.stop_time;
+	job.weight = record.weight;
+}
+
+void	Job_Set::get(rpc::v_jobs& jobs) const {
+	jobs.resize(this->_jobs.size());
+
+	for ( size_t i = 0 ; i < this->_jobs.size() ; ++i ) {
+		this->get(i, jobs[i]);
+	}
+}
+
+bool	Job_Set::equals(const s_job_record& job, const Job_Set& other, const s_job_record& other_job) const {
+	const s_time_constraint_record*	tcs = this->time_constraints(job);
+	const s_time_constraint_record*	other_tcs = other.time_constraints(other_job);
+
+	if ( job.name != other_job.name || job.domain != other_job.domain || job.node_name != other_job.node_name ||
+		job.cmd_line != other_job.cmd_line || job.state != other_job.state ||
+		job.recovery_short_label != other_job.recovery_short_label || job.recovery_label != other_job.recovery_label ||
+		job.recovery_action != other_job.recovery_action ||
+		job.return_code != other_job.return_code || job.start_time != other_job.start_time ||
+		job.stop_time != other_job.stop_time || job.weight != other_job.weight )
+		return false;
+
+	if ( job.nxt_count != other_job.nxt_count || job.prv_count != other_job.prv_count ||
+		job.time_constraints_count != other_job.time_constraints_count )
+		return false;
+
+	if ( std::equal(this->nxt(job), this->nxt(job) + job.nxt_count, other.nxt(other_job)) == false ||
+		std::equal(this->prv(job), this->prv(job) + job.prv_count, other.prv(other_job)) == false )
+		return false;
+
+	for ( uint32_t t = 0 ; t < job.time_constraints_count ; ++t ) {
+		if ( tcs[t].type != other_tcs[t].type || tcs[t].value != other_tcs[t].value )
+			return false;
+	}
+
+	return true;
+}
+
+String_Pool&	Job_Set::pool() const {
+	return *this->_pool;
+}
+
+size_t	Job_Set::memory() const {
+	return this->_jobs.capacity() * sizeof(s_job_record) +
+		this->_links.capacity() * sizeof(string_id) +
+		this->_time_constraints.capacity() * sizeof(s_time_constraint_record);
+}
+
+uint32_t	Job_Set::intern(const std::vector<std::string>& names) {
+	uint32_t	first = this->_links.size();
+
+	BOOST_FOREACH(const std::string& name, names) {
+		this->_links.push_back(this->_pool->intern(name));
+	}
+
+	return first;
+}
+
+void	Job_Set::names(const uint32_t& first, const uint32_t& count, std::vector<std::string>& result) const {
+	result.resize(count);
+
+	for ( uint32_t i = 0 ; i < count ; ++i ) {
+		result[i] = this->_pool->get(this->_links[first + i]).to_string();
+	}
+}
@@ -0,0 +1,104 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: job_watch.cpp
+ * Description: implements the comparison of successive job lists
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "job_watch.h"
+
+/**
+ * same_run
+ *
+ * Compares the attributes followed by the watch: the state, the return code,
+ * the start and the stop times
+ */
+static bool	same_run(const s_job_record& job, const s_job_record& other) {
+	return job.state == other.state && job.return_code == other.return_code &&
+		job.start_time == other.start_time && job.stop_time == other.stop_time;
+}
+
+Job_Watch::Job_Watch() : _previous(this->_pool), _current(this->_pool) {
+}
+
+void	Job_Watch::update(rpc::v_jobs& jobs, s_job_changes& changes) {
+	std::unordered_map<string_id, size_t>::const_iterator	previous;
+
+	changes.added.clear();
+	changes.changed.clear();
+	changes.removed.clear();
+
+	this->_current.clear();
+	this->_current.add(jobs);
+	jobs.clear();
+
+	this->_seen.assign(this->_previous.size(), false);
+
+	// Only the reported jobs are rebuilt
+	for ( size_t i = 0 ; i < this->_current.size() ; ++i ) {
+		const s_job_record&	job = this->_current.record(i);
+
+		previous = this->_positions.find(job.name);
+
+		if ( previous == this->_positions.end() ) {
+			changes.added.push_back(rpc::t_job());
+			this->_current.get(i, changes.added.back());
+			continue;
+		}
+
+		this->_seen[previous->second] = true;
+
+		if ( same_run(job, this->_previous.record(previous->second)) == false ) {
+			changes.changed.push_back(rpc::t_job());
+			this->_current.get(i, changes.changed.back());
+		}
+	}
+
+	// The jobs not seen by this update are gone
+	for ( size_t i = 0 ; i < this->_seen.size() ; ++i ) {
+		if ( this->_seen[i] == true )
+			continue;
+
+		changes.removed.push_back(rpc::t_job());
+		this->_previous.get(i, changes.removed.back());
+	}
+
+	std::swap(this->_previous, this->_current);
+
+	this->_positions.clear();
+	for ( size_t i = 0 ; i < this->_previous.size() ; ++i ) {
+		this->_positions[this->_previous.record(i).name] = i;
+	}
+}
+
+void	Job_Watch::clear() {
+	this->_previous.clear();
+	this->_current.clear();
+	this->_positions.clear();
+	this->_seen.clear();
+	this->_pool.clear();
+}
+
+size_t	Job_Watch::size() const {
+	return this->_previous.size();
+}
@@ -0,0 +1,410 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: json_reader.cpp
+ * Description: implements the single-pass JSON reader
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <cstring>
+
+#include "json_reader.h"
+
+Json_Reader::Json_Reader(const char* data, const size_t& size, const size_t& line_number) :
+	_position(data), _end(data + size), _line_number(line_number + 1), _error(NULL) {
+}
+
+char	Json_Reader::peek() {
+	// The new lines can only be found between the tokens
+	while ( this->_position < this->_end ) {
+		switch (*this->_position) {
+			case '\n':
+				this->_line_number++;
+				// fall through
+			case ' ':
+			case '\t':
+			case '\r':
+				this->_position++;
+				break;
+			default:
+				return *this->_position;
+		}
+	}
+
+	return '\0';
+}
+
+bool	Json_Reader::begin_object() {
+	if ( this->expect('{') == false )
+		return false;
+
+	// skip_value recurses once per level
+	if ( this->_first.size() >= JSON_MAX_DEPTH )
+		return this->fail("too deeply nested");
+
+	this->_first.push_back(true);
+	return true;
+}
+
+bool	Json_Reader::next_member(boost::string_view& key, bool& more) {
+	if ( this->next('}', more) == false )
+		return false;
+
+	if ( more == false )
+		return true;
+
+	if ( this->peek() != '"' )
+		return this->fail("a member's name is expected");
+
+	if ( this->scan_string(key, this->_key_buffer) == false )
+		return false;
+
+	return this->expect(':');
+}
+
+bool	Json_Reader::begin_array() {
+	if ( this->expect('[') == false )
+		return false;
+
+	// skip_value recurses once per level
+	if ( this->_first.size() >= JSON_MAX_DEPTH )
+		return this->fail("too deeply nested");
+
+	this->_first.push_back(true);
+	return true;
+}
+
+bool	Json_Reader::next_item(bool& more) {
+	return this->next(']', more);
+}
+
+bool	Json_Reader::read_string(boost::string_view& value) {
+	if ( this->peek() != '"' )
+		return this->fail("a string is expected");
+
+	return this->scan_string(value, this->_value_buffer);
+}
+
+bool	Json_Reader::read_string(std::string& value) {
+	boost::string_view	view;
+
+	if ( this->read_string(view) == false )
+		return false;
+
+	value.assign(view.data(), view.size());
+	return true;
+}
+
+bool	Json_Reader::read_integer(int64_t& value) {
+	bool		negative = false;
+	uint64_t	result = 0;
+	const char*	first = NULL;
+
+	this->peek();
+
+	if ( this->_position < this->_end && *this->_position == '-' ) {
+		negative = true;
+		this->_position++;
+	}
+
+	first = this->_position;
+	while ( this->_position < this->_end && *this->_position >= '0' && *this->_position <= '9' ) {
+		if ( result > (UINT64_MAX - 9) / 10 )
+			return this->fail("the number is too big");
+
+		result = result * 10 + (*this->_position - '0');
+		this->_position++;
+	}
+
+	if ( this->_position == first )
+		return this->fail("a number is expected");
+
+	if ( this->_position < this->_end && ( *this->_position == '.' || *this->_position == 'e' || *this->_position == 'E' ) )
+		return this->fail("an integer is expected");
+
+	if ( result > static_cast<uint64_t>(INT64_MAX) + ( negative == true ? 1 : 0 ) )
+		return this->fail("the number is too big");
+
+	value = negative == true ? static_cast<int64_t>(0 - result) : static_cast<int64_t>(result);
+	return true;
+}
+
+bool	Json_Reader::skip_value() {
+	boost::string_view	s;
+	bool				more = true;
+
+	switch ( this->peek() ) {
+		case '"':
+			return this->scan_string(s, this->_value_buffer);
+		case '{':
+			if ( this->begin_object() == false )
+				return false;
+			while ( this->next_member(s, more) == true && more == true ) {
+				if ( this->skip_value() == false )
+					return false;
+			}
+			return this->_error == NULL;
+		case '[':
+			if ( this->begin_array() == false )
+				return false;
+			while ( this->next_item(more) == true && more == true ) {
+				if ( this->skip_value() == false )
+					return false;
+			}
+			return this->_error == NULL;
+		case 't':
+			return this->skip_literal("true");
+		case 'f':
+			return this->skip_literal("false");
+		case 'n':
+			return this->skip_literal("null");
+		case '\0':
+			return this->fail("a value is expected");
+	}
+
+	// A number: sign, digits, fraction and exponent
+	if ( *this->_position == '-' )
+		this->_position++;
+
+	if ( this->_position == this->_end || *this->_position < '0' || *this->_position > '9' )
+		return this->fail("unexpected character");
+
+	while ( this->_position < this->_end && ( ( *this->_position >= '0' && *this->_position <= '9' ) ||
+		*this->_position == '.' || *this->_position == 'e' || *this->_position == 'E' || *this->_position == '+' || *this->_position == '-' ) )
+		this->_position++;
+
+	return true;
+}
+
+size_t	Json_Reader::line_number() const {
+	return this->_line_number;
+}
+
+const char*	Json_Reader::error() const {
+	return this->_error == NULL ? "" : this->_error;
+}
+
+bool	Json_Reader::fail(const char* message) {
+	if ( this->_error == NULL )
+		this->_error = message;
+
+	return false;
+}
+
+bool	Json_Reader::expect(const char& c) {
+	if ( this->peek() != c ) {
+		switch (c) {
+			case '{':
+				return this->fail("'{' is expected");
+			case '[':
+				return this->fail("'[' is expected");
+			case ':':
+				return this->fail("':' is expected");
+			default:
+				return this->fail("unexpected character");
+		}
+	}
+
+	this->_position++;
+	return true;
+}
+
+bool	Json_Reader::next(const char& end, bool& more) {
+	char	c = this->peek();
+
+	more = false;
+
+	if ( this->_first.empty() == true )
+		return this->fail("no container is opened");
+
+	if ( c == end ) {
+		this->_position++;
+		this->_first.pop_back();
+		return true;
+	}
+
+	if ( this->_first.back() == true ) {
+		this->_first.back() = false;
+	} else if ( c == ',' ) {
+		this->_position++;
+	} else {
+		return this->fail(end == '}' ? "',' or '}' is expected" : "',' or ']' is expected");
+	}
+
+	more = true;
+	return true;
+}
+
+/**
+ * hex_value
+ *
+ * @return	the value of the hexadecimal digit, -1 if c is not one
+ */
+static inline int	hex_value(const char& c) {
+	if ( c >= '0' && c <= '9' )
+		return c - '0';
+	if ( c >= 'a' && c <= 'f' )
+		return c - 'a' + 10;
+	if ( c >= 'A' && c <= 'F' )
+		return c - 'A' + 10;
+	return -1;
+}
+
+/**
+ * append_utf8
+ */
+static void	append_utf8(std::string& buffer, const uint32_t& code_point) {
+	if ( code_point < 0x80 ) {
+		buffer += static_cast<char>(code_point);
+	} else if ( code_point < 0x800 ) {
+		buffer += static_cast<char>(0xc0 | code_point >> 6);
+		buffer += static_cast<char>(0x80 | ( code_point & 0x3f ));
+	} else if ( code_point < 0x10000 ) {
+		buffer += static_cast<char>(0xe0 | code_point >> 12);
+		buffer += static_cast<char>(0x80 | ( code_point >> 6 & 0x3f ));
+		buffer += static_cast<char>(0x80 | ( code_point & 0x3f ));
+	} else {
+		buffer += static_cast<char>(0xf0 | code_point >> 18);
+		buffer += static_cast<char>(0x80 | ( code_point >> 12 & 0x3f ));
+		buffer += static_cast<char>(0x80 | ( code_point >> 6 & 0x3f ));
+		buffer += static_cast<char>(0x80 | ( code_point & 0x3f ));
+	}
+}
+
+bool	Json_Reader::scan_string(boost::string_view& value, std::string& buffer) {
+	const char*	begin = ++this->_position;
+	bool		escaped = false;
+
+	while ( this->_position < this->_end ) {
+		char	c = *this->_position;
+
+		if ( c == '"' ) {
+			if ( escaped == true ) {
+				buffer.append(begin, this->_position - begin);
+				value = boost::string_view(buffer);
+			} else {
+				value = boost::string_view(begin, this->_position - begin);
+			}
+
+			this->_position++;
+			return true;
+		}
+
+		if ( static_cast<unsigned char>(c) < 0x20 )
+			return this->fail("control character in a string");
+
+		if ( c != '\\' ) {
+			this->_position++;
+			continue;
+		}
+
+		// The escapes are decoded into the buffer, with the text before them
+		if ( escaped == false ) {
+			buffer.clear();
+			escaped = true;
+		}
+		buffer.append(begin, this->_position - begin);
+
+		if ( ++this->_position == this->_end )
+			break;
+
+		switch (*this->_position) {
+			case '"':
+			case '\\':
+			case '/':
+				buffer += *this->_position;
+				break;
+			case 'b':
+				buffer += '\b';
+				break;
+			case 'f':
+				buffer += '\f';
+				break;
+			case 'n':
+				buffer += '\n';
+				break;
+			case 'r':
+				buffer += '\r';
+				break;
+			case 't':
+				buffer += '\t';
+				break;
+			case 'u': {
+				uint32_t	code_point = 0;
+
+				for ( int pair = 0 ; pair < 2 ; ++pair ) {
+					uint32_t	unit = 0;
+
+					if ( this->_end - this->_position < 5 )
+						return this->fail("truncated \\u escape");
+
+					for ( int i = 1 ; i <= 4 ; ++i ) {
+						int	v = hex_value(this->_position[i]);
+
+						if ( v < 0 )
+							return this->fail("bad \\u escape");
+						unit = unit << 4 | v;
+					}
+					this->_position += 4;
+
+					if ( pair == 0 ) {
+						code_point = unit;
+
+						// A low surrogate cannot come first
+						if ( unit >= 0xdc00 && unit <= 0xdfff )
+							return this->fail("lone surrogate in a \\u escape");
+
+						// A high surrogate must be followed by a low one
+						if ( unit < 0xd800 || unit > 0xdbff )
+							break;
+						if ( this->_end - this->_position < 3 || this->_position[1] != '\\' || this->_position[2] != 'u' )
+							return this->fail("lone surrogate in a \\u escape");
+						this->_position += 2;
+					} else {
+						if ( unit < 0xdc00 || unit > 0xdfff )
+							return this->fail("lone surrogate in a \\u escape");
+						code_point = 0x10000 + ( ( code_point - 0xd800 ) << 10 ) + ( unit - 0xdc00 );
+					}
+				}
+
+				append_utf8(buffer, code_point);
+				break;
+			}
+			default:
+				return this->fail("bad escape");
+		}
+
+		begin = ++this->_position;
+	}
+
+	return this->fail("unterminated string");
+}
+
+bool	Json_Reader::skip_literal(const char* literal) {
+	size_t	size = strlen(literal);
+
+	if ( static_cast<size_t>(this->_end - this->_position) < size || memcmp(this->_position, literal, size) != 0 )
+		return this->fail("unexpected character");
+
+	this->_position += size;
+	return true;
+}
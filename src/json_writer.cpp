@@ -0,0 +1,202 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: json_writer.cpp
+ * Description: implements the streaming JSON writer
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "json_writer.h"
+
+Json_Writer::Json_Writer(Output_Buffer& buffer, const bool& pretty, const char& indent_character, const size_t& depth) :
+	_buffer(buffer), _pretty(pretty), _indent(16, indent_character), _depth(depth), _after_key(false) {
+}
+
+void	Json_Writer::begin_object() {
+	this->next_item();
+	this->_buffer.append('{');
+	this->_has_items.push_back(false);
+	this->_depth++;
+}
+
+void	Json_Writer::end_object() {
+	bool	has_items = this->_has_items.back();
+
+	this->_has_items.pop_back();
+	this->_depth--;
+
+	if ( has_items == true )
+		this->new_line();
+	this->_buffer.append('}');
+}
+
+void	Json_Writer::begin_array() {
+	this->next_item();
+	this->_buffer.append('[');
+	this->_has_items.push_back(false);
+	this->_depth++;
+}
+
+void	Json_Writer::end_array() {
+	bool	has_items = this->_has_items.back();
+
+	this->_has_items.pop_back();
+	this->_depth--;
+
+	if ( has_items == true )
+		this->new_line();
+	this->_buffer.append(']');
+}
+
+void	Json_Writer::enter_array(const bool& has_items) {
+	this->_has_items.push_back(has_items);
+	this->_depth++;
+}
+
+void	Json_Writer::leave_array() {
+	this->_has_items.pop_back();
+	this->_depth--;
+}
+
+void	Json_Writer::key(const char* name) {
+	this->next_item();
+	this->write_escaped(name, strlen(name));
+
+	if ( this->_pretty == true )
+		this->_buffer.append(": ", 2);
+	else
+		this->_buffer.append(':');
+
+	this->_after_key = true;
+}
+
+void	Json_Writer::value(const boost::string_view& v) {
+	this->next_item();
+	this->write_escaped(v.data(), v.size());
+}
+
+void	Json_Writer::value(const char* v, const size_t& size) {
+	this->next_item();
+	this->write_escaped(v, size);
+}
+
+void	Json_Writer::value(const int64_t& v) {
+	this->next_item();
+	this->_buffer.append_integer(v);
+}
+
+void	Json_Writer::value(const std::vector<std::string>& v) {
+	this->begin_array();
+	BOOST_FOREACH(const std::string& s, v) {
+		this->value(s);
+	}
+	this->end_array();
+}
+
+void	Json_Writer::member(const char* name, const boost::string_view& v) {
+	this->key(name);
+	this->value(v);
+}
+
+void	Json_Writer::member(const char* name, const int64_t& v) {
+	this->key(name);
+	this->value(v);
+}
+
+void	Json_Writer::member(const char* name, const std::vector<std::string>& v) {
+	this->key(name);
+	this->value(v);
+}
+
+void	Json_Writer::next_item() {
+	if ( this->_after_key == true ) {
+		this->_after_key = false;
+		return;
+	}
+
+	// Top-level value
+	if ( this->_has_items.empty() == true )
+		return;
+
+	if ( this->_has_items.back() == true )
+		this->_buffer.append(',');
+	else
+		this->_has_items.back() = true;
+
+	this->new_line();
+}
+
+void	Json_Writer::new_line() {
+	if ( this->_pretty == false )
+		return;
+
+	if ( this->_indent.size() < this->_depth )
+		this->_indent.resize(this->_depth * 2, this->_indent[0]);
+
+	this->_buffer.append('\n');
+	this->_buffer.append(this->_indent.data(), this->_depth);
+}
+
+void	Json_Writer::write_escaped(const char* v, const size_t& size) {
+	static const char	hex[] = "0123456789abcdef";
+	const char*			run = v;
+	const char*			end = v + size;
+	char				escaped[6] = { '\\', 'u', '0', '0', '0', '0' };
+
+	this->_buffer.append('"');
+
+	// Safe characters are copied by runs, only the special ones are escaped
+	for ( const char* c = v ; c < end ; ++c ) {
+		unsigned char	u = static_cast<unsigned char>(*c);
+
+		if ( u >= 0x20 && u != '"' && u != '\\' )
+			continue;
+
+		this->_buffer.append(run, c - run);
+		run = c + 1;
+
+		switch (u) {
+			case '"':
+				this->_buffer.append("\\\"", 2);
+				break;
+			case '\\':
+				this->_buffer.append("\\\\", 2);
+				break;
+			case '\n':
+				this->_buffer.append("\\n", 2);
+				break;
+			case '\r':
+				this->_buffer.append("\\r", 2);
+				break;
+			case '\t':
+				this->_buffer.append("\\t", 2);
+				break;
+			default:
+				escaped[4] = hex[u >> 4];
+				escaped[5] = hex[u & 0x0f];
+				this->_buffer.append(escaped, sizeof(escaped));
+		}
+	}
+
+	this->_buffer.append(run, end - run);
+	this->_buffer.append('"');
+}
@@ -46,6 +46,7 @@
 #include <time.h>
 #ifndef WIN32
 #include <regex.h>
+#include <sys/select.h>
 #endif
 #include "libcli.h"
 
@@ -1251,6 +1252,34 @@ void cli_regular_interval(struct cli_def *cli, int seconds)
 	cli->timeout_tm.tv_usec = 0;
 }
 
+/*
+ * readline owns the terminal between the commands, so the regular callback
+ * is run by the command which set it: it is called every interval until it
+ * returns something else than CLI_OK, then it is removed.
+ */
+int cli_run_regular(struct cli_def *cli)
+{
+	int rc = CLI_OK;
+
+	if (!cli || !cli->regular_callback) return CLI_ERROR;
+
+	while ((rc = cli->regular_callback(cli)) == CLI_OK)
+	{
+		struct timeval tm = cli->timeout_tm;
+
+		// A signal ends the wait early, the callback decides what to do
+		if (select(0, NULL, NULL, NULL, &tm) < 0 && errno != EINTR)
+		{
+			rc = CLI_ERROR;
+			break;
+		}
+	}
+
+	cli->regular_callback = NULL;
+
+	return rc == CLI_QUIT ? CLI_OK : rc;
+}
+
 #define DES_PREFIX "{crypt}"        /* to distinguish clear text from DES crypted */
 #define MD5_PREFIX "$1$"
 /*
@@ -149,7 +149,7 @@ int	main(const int argc, char const* argv[]) {
 	client.open(routing.target_node.name.c_str(), port);
 
 	if ( metric.compare("all") == 0 ) {
-		BOOST_FOREACH(std::string command, metrics) {
+		BOOST_FOREACH(const std::string& command, metrics) {
 			if ( get_metric(result, command, client, routing) == false ) {
 				client.close();
 				return MON_UNKNOWN;
@@ -0,0 +1,125 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: node_fan_out.cpp
+ * Description: implements the parallel requests sent to every node of a domain
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "node_fan_out.h"
+
+Node_Fan_Out::Node_Fan_Out(Connection_Pool& pool, const rpc::t_routing_data& routing, const int& port) : _pool(pool), _routing(routing), _port(port), _next(0) {
+}
+
+void	Node_Fan_Out::get_jobs(const rpc::v_nodes& nodes, const size_t& workers, v_node_jobs& results) {
+	boost::thread_group	threads;
+
+	results.clear();
+	results.resize(nodes.size());
+
+	for ( size_t i = 0 ; i < nodes.size() ; ++i ) {
+		results[i].node = nodes[i];
+		results[i].seconds = 0;
+	}
+
+	this->_next = 0;
+
+	for ( size_t w = 0 ; w < std::min(workers, nodes.size()) ; ++w ) {
+		threads.create_thread(boost::bind(&Node_Fan_Out::work, this, &results));
+	}
+
+	threads.join_all();
+}
+
+void	Node_Fan_Out::work(v_node_jobs* results) {
+	while ( true ) {
+		size_t	i;
+
+		{
+			boost::lock_guard<boost::mutex>	lock(this->_mutex);
+
+			if ( this->_next >= results->size() )
+				return;
+
+			i = this->_next++;
+		}
+
+		// Each worker writes its own entries only
+		this->get_node_jobs((*results)[i]);
+	}
+}
+
+void	Node_Fan_Out::get_node_jobs(s_node_jobs& result) {
+	std::chrono::steady_clock::time_point	start = std::chrono::steady_clock::now();
+	rpc::t_routing_data						routing = this->_routing;
+	std::unique_ptr<s_connection>			connection;
+
+	routing.target_node.name = result.node.name;
+	routing.target_node.domain_name = result.node.domain_name;
+
+	connection = this->_pool.acquire(s_endpoint(result.node.name, this->_port, result.node.domain_name));
+
+	if ( connection.get() == NULL ) {
+		result.error = "cannot connect";
+	} else {
+		try {
+			connection->client.get_handler()->get_jobs(result.jobs, routing);
+		} catch (const rpc::ex_routing& e) {
+			result.error = "ex::routing: " + e.msg;
+		} catch (const rpc::ex_node& e) {
+			result.error = "ex::node: " + e.msg;
+		} catch (const std::exception& e) {
+			result.error = e.what();
+			connection->broken = true;
+		}
+
+		this->_pool.release(std::move(connection));
+	}
+
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+size_t	merge_node_jobs(v_node_jobs& results, rpc::v_jobs& jobs) {
+	size_t	total = jobs.size();
+	size_t	failed = 0;
+
+	BOOST_FOREACH(const s_node_jobs& result, results) {
+		total += result.jobs.size();
+	}
+
+	jobs.reserve(total);
+
+	BOOST_FOREACH(s_node_jobs& result, results) {
+		if ( result.error.empty() == false )
+			failed++;
+
+		BOOST_FOREACH(rpc::t_job& job, result.jobs) {
+			if ( job.node_name.empty() == true )
+				job.node_name = result.node.name;
+		}
+
+		jobs.insert(jobs.end(), std::make_move_iterator(result.jobs.begin()), std::make_move_iterator(result.jobs.end()));
+		result.jobs.clear();
+	}
+
+	return failed;
+}
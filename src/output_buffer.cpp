@@ -0,0 +1,159 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: output_buffer.cpp
+ * Description: implements the buffer used to stream large outputs
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/uio.h>
+#include <limits.h>
+
+#include "output_buffer.h"
+
+Output_Buffer::Output_Buffer(std::ostream& sink, const size_t& flush_size) : _sink(&sink), _data(flush_size), _size(0) {
+}
+
+Output_Buffer::Output_Buffer(const size_t& initial_size) : _sink(NULL), _data(initial_size), _size(0) {
+}
+
+Output_Buffer::~Output_Buffer() {
+	this->flush();
+}
+
+void	Output_Buffer::append(const char* data, const size_t& size) {
+	if ( this->_size + size > this->_data.size() ) {
+		if ( this->_sink == NULL ) {
+			this->_data.resize(std::max(this->_data.size() * 2, this->_size + size));
+		} else {
+			this->flush();
+
+			// Too big to be buffered
+			if ( size > this->_data.size() ) {
+				this->_sink->write(data, size);
+				return;
+			}
+		}
+	}
+
+	memcpy(&this->_data[this->_size], data, size);
+	this->_size += size;
+}
+
+void	Output_Buffer::append(const boost::string_view& data) {
+	this->append(data.data(), data.size());
+}
+
+void	Output_Buffer::append(const char& c) {
+	if ( this->_size == this->_data.size() ) {
+		if ( this->_sink == NULL )
+			this->_data.resize(this->_data.size() * 2 + 1);
+		else
+			this->flush();
+	}
+
+	this->_data[this->_size++] = c;
+}
+
+void	Output_Buffer::append_integer(const int64_t& value) {
+	char		digits[OUTPUT_INTEGER_SIZE];
+	const char*	begin = format_integer(value, digits);
+
+	this->append(begin, digits + OUTPUT_INTEGER_SIZE - begin);
+}
+
+void	Output_Buffer::flush() {
+	if ( this->_size == 0 || this->_sink == NULL )
+		return;
+
+	this->_sink->write(this->_data.data(), this->_size);
+	this->_size = 0;
+}
+
+const char*	Output_Buffer::data() const {
+	return this->_data.data();
+}
+
+size_t	Output_Buffer::size() const {
+	return this->_size;
+}
+
+void	Output_Buffer::clear() {
+	this->_size = 0;
+}
+
+const char*	format_integer(const int64_t& value, char (&digits)[OUTPUT_INTEGER_SIZE]) {
+	char*		cursor = digits + OUTPUT_INTEGER_SIZE;
+	uint64_t	absolute = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+
+	do {
+		*--cursor = '0' + absolute % 10;
+		absolute /= 10;
+	} while ( absolute != 0 );
+
+	if ( value < 0 )
+		*--cursor = '-';
+
+	return cursor;
+}
+
+bool	write_buffers(const int& fd, const std::vector<const Output_Buffer*>& buffers) {
+	std::vector<struct iovec>	vectors;
+	size_t						first = 0;
+
+	BOOST_FOREACH(const Output_Buffer* buffer, buffers) {
+		struct iovec	v;
+
+		if ( buffer->size() == 0 )
+			continue;
+
+		v.iov_base = const_cast<char*>(buffer->data());
+		v.iov_len = buffer->size();
+		vectors.push_back(v);
+	}
+
+	while ( first < vectors.size() ) {
+		ssize_t	written = writev(fd, &vectors[first], std::min<size_t>(vectors.size() - first, IOV_MAX));
+
+		if ( written < 0 ) {
+			if ( errno == EINTR )
+				continue;
+			return false;
+		}
+
+		// Skip what has been written, the last vector can be partially written
+		while ( first < vectors.size() && static_cast<size_t>(written) >= vectors[first].iov_len ) {
+			written -= vectors[first].iov_len;
+			first++;
+		}
+
+		if ( first < vectors.size() ) {
+			vectors[first].iov_base = static_cast<char*>(vectors[first].iov_base) + written;
+			vectors[first].iov_len -= written;
+		}
+	}
+
+	return true;
+}
@@ -29,262 +29,1382 @@
 
 // TODO: http://stackoverflow.com/questions/8806643/colorized-output-breaks-linewrapping-with-readline
 
-void	get_indent(const s_printing_options& opts, const uint& number, std::string& _return) {
-	static uint _number = 0;
+/**
+ * render
+ *
+ * Renders the data to stdout or to opts.output_file using the given formatter
+ */
+template<typename Formatter, typename T>
+void	render(const s_printing_options& opts, const uint& indent, const T& data) {
+	std::ofstream	file;
+
+	if ( opts.output_file.empty() == false ) {
+		file.open(opts.output_file.c_str(), std::ios::out | std::ios::binary | ( opts.output_append == true ? std::ios::app : std::ios::trunc ));
+		if ( file.is_open() == false ) {
+			std::cerr << "Cannot open '" << opts.output_file << "': " << strerror(errno) << std::endl;
+			return;
+		}
+	}
+
+	Output_Buffer	buffer(file.is_open() ? static_cast<std::ostream&>(file) : std::cout);
+	Formatter		formatter(buffer, opts, indent);
+
+	formatter.write(data);
+	formatter.end();
+}
+
+/**
+ * render_items
+ *
+ * Renders list[first, last) into the buffer, this is the rendering threads' job
+ */
+template<typename Formatter, typename T>
+void	render_items(const s_printing_options& opts, const uint& indent, const T& list, const size_t& first, const size_t& last, Output_Buffer* buffer) {
+	Formatter	formatter(*buffer, opts, indent);
+
+	formatter.write_items(list, first, last);
+}
+
+/**
+ * render_list
+ *
+ * Renders the list using opts.render_threads threads. Each thread renders a
+ * chunk of the list into its own buffer, then the buffers are written in the
+ * list's order. The result is the same as render()'s one.
+ */
+template<typename Formatter, typename T>
+void	render_list(const s_printing_options& opts, const uint& indent, const T& list) {
+	std::vector<std::unique_ptr<Output_Buffer> >	buffers;
+	std::vector<const Output_Buffer*>				to_write;
+	Output_Buffer	edge;
+	size_t			chunk_size = 0;
+	int				fd = STDOUT_FILENO;
+	bool			failed = false;
+
+	if ( opts.render_threads < 2 || list.size() < 2 ) {
+		render<Formatter>(opts, indent, list);
+		return;
+	}
 
-	if ( _number > number ) {
-		for ( uint i = _return.size() ; i < number ; ++i ) {
-			_return += opts.indent_character;
+	if ( opts.output_file.empty() == false ) {
+		fd = open(opts.output_file.c_str(), O_WRONLY | O_CREAT | ( opts.output_append == true ? O_APPEND : O_TRUNC ), 0644);
+		if ( fd < 0 ) {
+			std::cerr << "Cannot open '" << opts.output_file << "': " << strerror(errno) << std::endl;
+			return;
 		}
 	} else {
-		if ( _number < number ) {
-			_return = "";
-			for ( uint i = 0 ; i < number ; ++i ) {
-				_return += opts.indent_character;
-			}
+		// What has been printed using std::cout must be written first
+		std::cout.flush();
+		fflush(stdout);
+	}
+
+	chunk_size = std::min<size_t>(PRINTING_CHUNK_SIZE, (list.size() + opts.render_threads - 1) / opts.render_threads);
+
+	for ( size_t i = 0 ; i < opts.render_threads ; ++i ) {
+		buffers.push_back(std::unique_ptr<Output_Buffer>(new Output_Buffer()));
+		to_write.push_back(buffers.back().get());
+	}
+
+	{
+		Formatter	formatter(edge, opts, indent);
+		formatter.write_head(list);
+	}
+	if ( write_buffers(fd, std::vector<const Output_Buffer*>(1, &edge)) == false ) {
+		std::cerr << "Cannot write the output: " << strerror(errno) << std::endl;
+		failed = true;
+	}
+	edge.clear();
+
+	for ( size_t first = 0 ; failed == false && first < list.size() ; first += chunk_size * buffers.size() ) {
+		boost::thread_group	workers;
+
+		for ( size_t i = 0 ; i < buffers.size() ; ++i ) {
+			size_t	chunk_first = first + i * chunk_size;
+			size_t	chunk_last = std::min(chunk_first + chunk_size, list.size());
+
+			buffers[i]->clear();
+
+			if ( chunk_first >= chunk_last )
+				continue;
+
+			workers.create_thread(boost::bind(&render_items<Formatter, T>, boost::cref(opts), indent, boost::cref(list), chunk_first, chunk_last, buffers[i].get()));
 		}
+		workers.join_all();
+
+		if ( write_buffers(fd, to_write) == false ) {
+			std::cerr << "Cannot write the output: " << strerror(errno) << std::endl;
+			failed = true;
+			break;
+		}
+	}
+
+	if ( failed == false ) {
+		Formatter	formatter(edge, opts, indent);
+		formatter.write_tail(list);
+		formatter.end();
+
+		if ( write_buffers(fd, std::vector<const Output_Buffer*>(1, &edge)) == false )
+			std::cerr << "Cannot write the output: " << strerror(errno) << std::endl;
+	}
+
+	if ( fd != STDOUT_FILENO )
+		close(fd);
+}
+
+/**
+ * print
+ *
+ * Chooses the formatter according to the output type
+ */
+template<typename T>
+void	print(const s_printing_options& opts, const uint& indent, const T& data) {
+	switch ( opts.output_type ) {
+		case plain:
+			render<Plain_Formatter>(opts, indent, data);
+			break;
+		case json:
+			render<Json_Formatter>(opts, indent, data);
+			break;
+		case ndjson:
+			render<Ndjson_Formatter>(opts, indent, data);
+			break;
+		case table:
+			render<Table_Formatter>(opts, indent, data);
+			break;
+		case csv:
+			render<Csv_Formatter>(opts, indent, data);
+			break;
+		case tsv:
+			render<Tsv_Formatter>(opts, indent, data);
+			break;
+		case binary:
+			render<Binary_Formatter>(opts, indent, data);
+			break;
+	}
+}
+
+/**
+ * print_list
+ *
+ * Chooses the formatter according to the output type, the list may be
+ * rendered by several threads
+ */
+template<typename T>
+void	print_list(const s_printing_options& opts, const uint& indent, const T& list) {
+	switch ( opts.output_type ) {
+		case plain:
+			render_list<Plain_Formatter>(opts, indent, list);
+			break;
+		case json:
+			render_list<Json_Formatter>(opts, indent, list);
+			break;
+		case ndjson:
+			render_list<Ndjson_Formatter>(opts, indent, list);
+			break;
+		case table:
+			// The columns' widths depend on the whole list
+			render<Table_Formatter>(opts, indent, list);
+			break;
+		case csv:
+			render_list<Csv_Formatter>(opts, indent, list);
+			break;
+		case tsv:
+			render_list<Tsv_Formatter>(opts, indent, list);
+			break;
+		case binary:
+			render_list<Binary_Formatter>(opts, indent, list);
+			break;
 	}
 }
 
 void	print_kv(const s_printing_options& opts, const uint& indent, const m_kv& kv) {
-	if ( opts.output_type == plain )
-		for ( const auto& pair : kv ) {
-			if ( pair.first.compare("command") == 0 && opts.verbose == false )
+	print(opts, indent, kv);
+}
+
+void	print_nodes(const s_printing_options& opts, const uint& indent, const rpc::v_nodes& nodes) {
+	print_list(opts, indent, nodes);
+}
+
+void	print_node(const s_printing_options& opts, const uint& indent, const rpc::t_node& node) {
+	print(opts, indent, node);
+}
+
+void	print_jobs(const s_printing_options& opts, const uint& indent, const rpc::v_jobs& jobs) {
+	print_list(opts, indent, jobs);
+}
+
+void	print_job(const s_printing_options& opts, const uint& indent, const rpc::t_job& job) {
+	print(opts, indent, job);
+}
+
+void	print_time_constraints(const s_printing_options& opts, const uint& indent, const rpc::v_time_constraints& tcs) {
+	print(opts, indent, tcs);
+}
+
+void	print_time_constraint(const s_printing_options& opts, const uint& indent, const rpc::t_time_constraint& tc) {
+	print(opts, indent, tc);
+}
+
+void	print_resources(const s_printing_options& opts, const uint& indent, const rpc::v_resources& resources) {
+	print(opts, indent, resources);
+}
+
+void	print_resource(const s_printing_options& opts, const uint& indent, const rpc::t_resource& resource) {
+	print(opts, indent, resource);
+}
+
+void	print_snapshot(const s_printing_options& opts, const uint& indent, const s_snapshot& snapshot) {
+	switch ( snapshot.type ) {
+		case SNAPSHOT_NODES:
+			print_nodes(opts, indent, snapshot.nodes);
+			break;
+		case SNAPSHOT_JOBS:
+			print_jobs(opts, indent, snapshot.jobs);
+			break;
+		case SNAPSHOT_TIME_CONSTRAINTS:
+			print_time_constraints(opts, indent, snapshot.time_constraints);
+			break;
+		case SNAPSHOT_RESOURCES:
+			print_resources(opts, indent, snapshot.resources);
+			break;
+		case SNAPSHOT_KV:
+			print_kv(opts, indent, snapshot.kv);
+			break;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//	plain
+///////////////////////////////////////////////////////////////////////////////
+
+Plain_Formatter::Plain_Formatter(Output_Buffer& buffer, const s_printing_options& opts, const uint& depth) :
+	_buffer(buffer), _opts(opts), _fields(opts.job_fields == 0 ? JOB_FIELDS_PLAIN : opts.job_fields), _depth(depth) {
+	memset(this->_indents, opts.indent_character, sizeof(this->_indents));
+}
+
+void	Plain_Formatter::write(const m_kv& kv) {
+	for ( const auto& pair : kv ) {
+		if ( pair.first.compare("command") == 0 && this->_opts.verbose == false )
+			continue;
+
+		this->indent();
+		this->_buffer.append(pair.first);
+		this->_buffer.append(": ", 2);
+		this->_buffer.append(pair.second);
+		this->_buffer.append('\n');
+	}
+}
+
+void	Plain_Formatter::write(const rpc::v_nodes& nodes) {
+	this->write_items(nodes, 0, nodes.size());
+}
+
+void	Plain_Formatter::write(const rpc::t_node& node) {
+	this->field("domain:	", 8, node.domain_name);
+	this->field("name:	", 6, node.name);
+	this->field("weight:	", 8, node.weight);
+
+	this->indent();
+	this->_buffer.append("jobs:	\n", 7);
+	this->_depth += 2;
+	this->write(node.jobs);
+	this->_depth -= 2;
+
+	this->indent();
+	this->_buffer.append("resources:\n", 11);
+	this->_depth += 2;
+	this->write(node.resources);
+	this->_depth -= 2;
+}
+
+void	Plain_Formatter::write(const rpc::v_jobs& jobs) {
+	this->write_items(jobs, 0, jobs.size());
+}
+
+void	Plain_Formatter::write(const rpc::t_job& job) {
+	if ( this->_fields & JOB_FIELD_NAME )
+		this->field("name:	", 6, job.name);
+	if ( this->_fields & JOB_FIELD_STATE )
+		this->field("state:	", 7, job_state_to_string(job.state));
+	if ( this->_fields & JOB_FIELD_CMD_LINE )
+		this->field("cmd_line:	", 10, job.cmd_line);
+	if ( this->_fields & JOB_FIELD_NODE_NAME )
+		this->field("node_name:	", 11, job.node_name);
+	if ( this->_fields & JOB_FIELD_NXT )
+		this->field("nxt:	", 5, job.nxt);
+	if ( this->_fields & JOB_FIELD_PRV )
+		this->field("prv:	", 5, job.prv);
+	if ( this->_fields & JOB_FIELD_RECOVERY_TYPE )
+		this->field("recovery_type:	", 15, recovery_type_action_to_string(job.recovery_type));
+	if ( this->_fields & JOB_FIELD_RETURN_CODE )
+		this->field("return_code:	", 13, job.return_code);
+	if ( this->_fields & JOB_FIELD_START_TIME )
+		this->field("start_time:	", 12, job.start_time);
+	if ( this->_fields & JOB_FIELD_STOP_TIME )
+		this->field("stop_time:	", 11, job.stop_time);
+	if ( this->_fields & JOB_FIELD_TIME_CONSTRAINTS ) {
+		this->indent();
+		this->_buffer.append("time_constraints:\n", 18);
+		this->_depth++;
+		this->write(job.time_constraints);
+		this->_depth--;
+	}
+	if ( this->_fields & JOB_FIELD_WEIGHT )
+		this->field("weight:	", 8, job.weight);
+}
+
+void	Plain_Formatter::write(const rpc::v_time_constraints& tcs) {
+	BOOST_FOREACH(const rpc::t_time_constraint& tc, tcs) {
+		this->write(tc);
+	}
+}
+
+void	Plain_Formatter::write(const rpc::t_time_constraint& tc) {
+	this->indent();
+	this->_buffer.append(time_constraint_type_to_string(tc.type));
+	this->_buffer.append(' ');
+	this->_buffer.append_integer(tc.value);
+	this->_buffer.append('\n');
+}
+
+void	Plain_Formatter::write(const rpc::v_resources& resources) {
+	BOOST_FOREACH(const rpc::t_resource& resource, resources) {
+		this->write(resource);
+	}
+}
+
+void	Plain_Formatter::write(const rpc::t_resource& resource) {
+	this->field("name:	", 6, resource.name);
+	this->field("current value:	", 15, resource.current_value);
+	this->field("initial value:	", 15, resource.initial_value);
+}
+
+void	Plain_Formatter::write_head(UNUSED(const rpc::v_nodes& nodes)) {
+}
+
+void	Plain_Formatter::write_items(const rpc::v_nodes& nodes, const size_t& first, const size_t& last) {
+	this->_depth++;
+	for ( size_t i = first ; i < last ; ++i ) {
+		this->write(nodes[i]);
+	}
+	this->_depth--;
+}
+
+void	Plain_Formatter::write_tail(UNUSED(const rpc::v_nodes& nodes)) {
+}
+
+void	Plain_Formatter::write_head(UNUSED(const rpc::v_jobs& jobs)) {
+}
+
+void	Plain_Formatter::write_items(const rpc::v_jobs& jobs, const size_t& first, const size_t& last) {
+	for ( size_t i = first ; i < last ; ++i ) {
+		this->write(jobs[i]);
+	}
+}
+
+void	Plain_Formatter::write_tail(UNUSED(const rpc::v_jobs& jobs)) {
+}
+
+void	Plain_Formatter::end() {
+}
+
+void	Plain_Formatter::field(const char* name, const size_t& size, const boost::string_view& value) {
+	this->indent();
+	this->_buffer.append(name, size);
+	this->_buffer.append(value);
+	this->_buffer.append('\n');
+}
+
+void	Plain_Formatter::field(const char* name, const size_t& size, const int64_t& value) {
+	this->indent();
+	this->_buffer.append(name, size);
+	this->_buffer.append_integer(value);
+	this->_buffer.append('\n');
+}
+
+void	Plain_Formatter::field(const char* name, const size_t& size, const std::vector<std::string>& values) {
+	this->indent();
+	this->_buffer.append(name, size);
+	for ( size_t i = 0 ; i < values.size() ; ++i ) {
+		if ( i > 0 )
+			this->_buffer.append(',');
+		this->_buffer.append(values[i]);
+	}
+	this->_buffer.append('\n');
+}
+
+void	Plain_Formatter::indent() {
+	this->_buffer.append(this->_indents, std::min<size_t>(this->_depth, PRINTING_MAX_INDENT));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//	json
+///////////////////////////////////////////////////////////////////////////////
+
+Json_Formatter::Json_Formatter(Output_Buffer& buffer, const s_printing_options& opts, const uint& depth, const bool& pretty) :
+	_buffer(buffer), _opts(opts), _fields(opts.job_fields == 0 ? JOB_FIELDS_ALL : opts.job_fields), _writer(buffer, pretty, opts.indent_character, depth) {
+}
+
+void	Json_Formatter::write(const m_kv& kv) {
+	this->_writer.begin_object();
+	if ( this->_opts.verbose == true ) {
+		this->_writer.member("command", kv.at("command"));
+		this->_writer.key("result");
+		this->_writer.begin_object();
+	}
+	for ( const auto& pair : kv ) {
+		if ( pair.first.compare("command") == 0 )
+			continue;
+
+		this->_writer.member(pair.first.c_str(), pair.second);
+	}
+	if ( this->_opts.verbose == true ) {
+		this->_writer.end_object();
+	}
+	this->_writer.end_object();
+}
+
+void	Json_Formatter::write(const rpc::v_nodes& nodes) {
+	this->write_head(nodes);
+	this->write_items(nodes, 0, nodes.size());
+	this->write_tail(nodes);
+}
+
+void	Json_Formatter::write(const rpc::t_node& node) {
+	this->_writer.begin_object();
+	this->_writer.member("domain", node.domain_name);
+	this->_writer.member("name", node.name);
+	this->_writer.member("weight", node.weight);
+
+	this->_writer.key("jobs");
+	this->write(node.jobs);
+
+	this->_writer.key("resources");
+	this->write(node.resources);
+	this->_writer.end_object();
+}
+
+void	Json_Formatter::write(const rpc::v_jobs& jobs) {
+	this->write_head(jobs);
+	this->write_items(jobs, 0, jobs.size());
+	this->write_tail(jobs);
+}
+
+void	Json_Formatter::write(const rpc::t_job& job) {
+	this->_writer.begin_object();
+	if ( this->_fields & JOB_FIELD_NAME )
+		this->_writer.member("name", job.name);
+	if ( this->_fields & JOB_FIELD_STATE )
+		this->_writer.member("state", job_state_to_string(job.state));
+	if ( this->_fields & JOB_FIELD_CMD_LINE )
+		this->_writer.member("cmd_line", job.cmd_line);
+	if ( this->_fields & JOB_FIELD_NODE_NAME )
+		this->_writer.member("node_name", job.node_name);
+	if ( this->_fields & JOB_FIELD_NXT )
+		this->_writer.member("nxt", job.nxt);
+	if ( this->_fields & JOB_FIELD_PRV )
+		this->_writer.member("prv", job.prv);
+	if ( this->_fields & JOB_FIELD_RECOVERY_TYPE )
+		this->_writer.member("recovery_type", recovery_type_action_to_string(job.recovery_type));
+	if ( this->_fields & JOB_FIELD_RETURN_CODE )
+		this->_writer.member("return_code", job.return_code);
+	if ( this->_fields & JOB_FIELD_START_TIME )
+		this->_writer.member("start_time", job.start_time);
+	if ( this->_fields & JOB_FIELD_STOP_TIME )
+		this->_writer.member("stop_time", job.stop_time);
+	if ( this->_fields & JOB_FIELD_TIME_CONSTRAINTS ) {
+		this->_writer.key("time_constraints");
+		this->write(job.time_constraints);
+	}
+	if ( this->_fields & JOB_FIELD_WEIGHT )
+		this->_writer.member("weight", job.weight);
+	this->_writer.end_object();
+}
+
+void	Json_Formatter::write(const rpc::v_time_constraints& tcs) {
+	this->_writer.begin_array();
+	BOOST_FOREACH(const rpc::t_time_constraint& tc, tcs) {
+		this->write(tc);
+	}
+	this->_writer.end_array();
+}
+
+void	Json_Formatter::write(const rpc::t_time_constraint& tc) {
+	this->_writer.begin_object();
+	this->_writer.member("type", time_constraint_type_to_string(tc.type));
+	this->_writer.member("value", tc.value);
+	this->_writer.end_object();
+}
+
+void	Json_Formatter::write(const rpc::v_resources& resources) {
+	this->_writer.begin_array();
+	BOOST_FOREACH(const rpc::t_resource& resource, resources) {
+		this->write(resource);
+	}
+	this->_writer.end_array();
+}
+
+void	Json_Formatter::write(const rpc::t_resource& resource) {
+	this->_writer.begin_object();
+	this->_writer.member("name", resource.name);
+	this->_writer.member("current_value", resource.current_value);
+	this->_writer.member("initial_value", resource.initial_value);
+	this->_writer.end_object();
+}
+
+void	Json_Formatter::write_head(UNUSED(const rpc::v_nodes& nodes)) {
+	this->_writer.begin_array();
+	this->_writer.leave_array();
+}
+
+void	Json_Formatter::write_items(const rpc::v_nodes& nodes, const size_t& first, const size_t& last) {
+	this->_writer.enter_array(first > 0);
+	for ( size_t i = first ; i < last ; ++i ) {
+		this->write(nodes[i]);
+	}
+	this->_writer.leave_array();
+}
+
+void	Json_Formatter::write_tail(const rpc::v_nodes& nodes) {
+	this->_writer.enter_array(nodes.empty() == false);
+	this->_writer.end_array();
+}
+
+void	Json_Formatter::write_head(UNUSED(const rpc::v_jobs& jobs)) {
+	this->_writer.begin_array();
+	this->_writer.leave_array();
+}
+
+void	Json_Formatter::write_items(const rpc::v_jobs& jobs, const size_t& first, const size_t& last) {
+	this->_writer.enter_array(first > 0);
+	for ( size_t i = first ; i < last ; ++i ) {
+		this->write(jobs[i]);
+	}
+	this->_writer.leave_array();
+}
+
+void	Json_Formatter::write_tail(const rpc::v_jobs& jobs) {
+	this->_writer.enter_array(jobs.empty() == false);
+	this->_writer.end_array();
+}
+
+void	Json_Formatter::end() {
+	this->_buffer.append('\n');
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//	ndjson
+///////////////////////////////////////////////////////////////////////////////
+
+Ndjson_Formatter::Ndjson_Formatter(Output_Buffer& buffer, const s_printing_options& opts, const uint& depth) :
+	Json_Formatter(buffer, opts, depth, false) {
+}
+
+void	Ndjson_Formatter::write(const m_kv& kv) {
+	Json_Formatter::write(kv);
+	this->_buffer.append('\n');
+}
+
+void	Ndjson_Formatter::write(const rpc::v_nodes& nodes) {
+	this->write_items(nodes, 0, nodes.size());
+}
+
+void	Ndjson_Formatter::write(const rpc::t_node& node) {
+	Json_Formatter::write(node);
+	this->_buffer.append('\n');
+}
+
+void	Ndjson_Formatter::write(const rpc::v_jobs& jobs) {
+	this->write_items(jobs, 0, jobs.size());
+}
+
+void	Ndjson_Formatter::write(const rpc::t_job& job) {
+	Json_Formatter::write(job);
+	this->_buffer.append('\n');
+}
+
+void	Ndjson_Formatter::write(const rpc::v_time_constraints& tcs) {
+	BOOST_FOREACH(const rpc::t_time_constraint& tc, tcs) {
+		this->write(tc);
+	}
+}
+
+void	Ndjson_Formatter::write(const rpc::t_time_constraint& tc) {
+	Json_Formatter::write(tc);
+	this->_buffer.append('\n');
+}
+
+void	Ndjson_Formatter::write(const rpc::v_resources& resources) {
+	BOOST_FOREACH(const rpc::t_resource& resource, resources) {
+		this->write(resource);
+	}
+}
+
+void	Ndjson_Formatter::write(const rpc::t_resource& resource) {
+	Json_Formatter::write(resource);
+	this->_buffer.append('\n');
+}
+
+void	Ndjson_Formatter::write_head(UNUSED(const rpc::v_nodes& nodes)) {
+}
+
+void	Ndjson_Formatter::write_items(const rpc::v_nodes& nodes, const size_t& first, const size_t& last) {
+	for ( size_t i = first ; i < last ; ++i ) {
+		this->write(nodes[i]);
+	}
+}
+
+void	Ndjson_Formatter::write_tail(UNUSED(const rpc::v_nodes& nodes)) {
+}
+
+void	Ndjson_Formatter::write_head(UNUSED(const rpc::v_jobs& jobs)) {
+}
+
+void	Ndjson_Formatter::write_items(const rpc::v_jobs& jobs, const size_t& first, const size_t& last) {
+	for ( size_t i = first ; i < last ; ++i ) {
+		this->write(jobs[i]);
+	}
+}
+
+void	Ndjson_Formatter::write_tail(UNUSED(const rpc::v_jobs& jobs)) {
+}
+
+void	Ndjson_Formatter::end() {
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//	table
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * A cell's text is given to a sink piece by piece: the same code is used to
+ * measure the cell and to write it, without building a string.
+ */
+
+/**
+ * @brief The Width_Sink struct
+ *
+ * Measures the text
+ */
+struct Width_Sink {
+	size_t	width;
+
+	Width_Sink() : width(0) {
+	}
+
+	void	text(UNUSED(const char* data), const size_t& size) {
+		this->width += size;
+	}
+};
+
+/**
+ * @brief The Cell_Sink struct
+ *
+ * Writes at most remaining bytes of the text, the control characters are
+ * replaced by spaces to keep the rows on one line
+ */
+struct Cell_Sink {
+	Output_Buffer&	buffer;
+	size_t			remaining;
+
+	Cell_Sink(Output_Buffer& b, const size_t& r) : buffer(b), remaining(r) {
+	}
+
+	void	text(const char* data, const size_t& size) {
+		size_t		length = std::min(size, this->remaining);
+		const char*	run = data;
+
+		for ( const char* c = data ; c < data + length ; ++c ) {
+			if ( static_cast<unsigned char>(*c) >= 0x20 )
 				continue;
-			std::cout << pair.first << ": " << pair.second << std::endl;
-		}
-	else if ( opts.output_type == json ) {
-		size_t counter = 1;
 
-		std::cout << "{";
-		if ( opts.verbose == true ) {
-			std::cout << std::endl << "'command':'" << kv.at("command") << "'," << std::endl;
-			std::cout << "'result':{";
+			this->buffer.append(run, c - run);
+			this->buffer.append(' ');
+			run = c + 1;
 		}
-		for ( const auto& pair : kv ) {
-			++counter;
+		this->buffer.append(run, data + length - run);
 
-			if ( pair.first.compare("command") == 0 )
-				continue;
+		this->remaining -= length;
+	}
+};
+
+template<typename Sink>
+void	sink_string(Sink& sink, const boost::string_view& s) {
+	sink.text(s.data(), s.size());
+}
+
+template<typename Sink>
+void	sink_integer(Sink& sink, const int64_t& value) {
+	char		digits[OUTPUT_INTEGER_SIZE];
+	const char*	begin = format_integer(value, digits);
+
+	sink.text(begin, digits + OUTPUT_INTEGER_SIZE - begin);
+}
+
+template<typename Sink>
+void	sink_strings(Sink& sink, const std::vector<std::string>& values) {
+	for ( size_t i = 0 ; i < values.size() ; ++i ) {
+		if ( i > 0 )
+			sink.text(",", 1);
+		sink_string(sink, values[i]);
+	}
+}
 
-			std::cout << "'" << pair.first << "':'" << pair.second << "'";
+/**
+ * @brief The Table_Row struct
+ *
+ * Describes the columns of the tables of T: their headers and how to get
+ * the cells' text
+ */
+template<typename T>
+struct Table_Row;
+
+template<>
+struct Table_Row<rpc::t_time_constraint> {
+	static const char*	headers[];
 
-			if ( counter < kv.bucket_count() - 1)
-				std::cout << ",";
+	template<typename Sink>
+	static void	cell(const rpc::t_time_constraint& tc, const size_t& column, Sink& sink) {
+		switch (column) {
+			case 0:
+				sink_string(sink, time_constraint_type_to_string(tc.type));
+				break;
+			case 1:
+				sink_integer(sink, tc.value);
+				break;
 		}
-		if ( opts.verbose == true ) {
-			std::cout << "}" << std::endl;
+	}
+};
+
+const char*	Table_Row<rpc::t_time_constraint>::headers[] = {
+	"TYPE", "VALUE"
+};
+
+template<>
+struct Table_Row<rpc::t_job> {
+	// Same order as the e_job_field bits
+	static const char*	headers[];
+
+	template<typename Sink>
+	static void	cell(const rpc::t_job& job, const size_t& column, Sink& sink) {
+		switch (column) {
+			case 0:
+				sink_string(sink, job.name);
+				break;
+			case 1:
+				sink_string(sink, job_state_to_string(job.state));
+				break;
+			case 2:
+				sink_string(sink, job.cmd_line);
+				break;
+			case 3:
+				sink_string(sink, job.node_name);
+				break;
+			case 4:
+				sink_strings(sink, job.nxt);
+				break;
+			case 5:
+				sink_strings(sink, job.prv);
+				break;
+			case 6:
+				sink_string(sink, recovery_type_action_to_string(job.recovery_type));
+				break;
+			case 7:
+				sink_integer(sink, job.return_code);
+				break;
+			case 8:
+				sink_integer(sink, job.start_time);
+				break;
+			case 9:
+				sink_integer(sink, job.stop_time);
+				break;
+			case 10:
+				for ( size_t i = 0 ; i < job.time_constraints.size() ; ++i ) {
+					if ( i > 0 )
+						sink.text(",", 1);
+					Table_Row<rpc::t_time_constraint>::cell(job.time_constraints[i], 0, sink);
+					sink.text(" ", 1);
+					Table_Row<rpc::t_time_constraint>::cell(job.time_constraints[i], 1, sink);
+				}
+				break;
+			case 11:
+				sink_integer(sink, job.weight);
+				break;
 		}
-		std::cout << "}" << std::endl;
 	}
-}
+};
 
-void	print_nodes(const s_printing_options& opts, const uint& indent, const rpc::v_nodes& nodes) {
-	std::string	str_indent;
-	get_indent(opts, indent, str_indent);
+const char*	Table_Row<rpc::t_job>::headers[] = {
+	"NAME", "STATE", "CMD_LINE", "NODE_NAME", "NXT", "PRV", "RECOVERY_TYPE",
+	"RETURN_CODE", "START_TIME", "STOP_TIME", "TIME_CONSTRAINTS", "WEIGHT"
+};
+
+template<>
+struct Table_Row<rpc::t_node> {
+	static const char*	headers[];
 
-	if ( opts.output_type == plain ) {
-		BOOST_FOREACH(rpc::t_node node, nodes) {
-			print_node(opts, indent + 1, node);
+	template<typename Sink>
+	static void	cell(const rpc::t_node& node, const size_t& column, Sink& sink) {
+		switch (column) {
+			case 0:
+				sink_string(sink, node.domain_name);
+				break;
+			case 1:
+				sink_string(sink, node.name);
+				break;
+			case 2:
+				sink_integer(sink, node.weight);
+				break;
+			case 3:
+				sink_integer(sink, node.jobs.size());
+				break;
+			case 4:
+				sink_integer(sink, node.resources.size());
+				break;
 		}
-	} else {
-		size_t	iter = 0;
-
-		std::cout << str_indent << "[" << std::endl;
-		BOOST_FOREACH(rpc::t_node node, nodes) {
-			print_node(opts, indent + 1, node);
-			if ( iter < nodes.size() - 1 ) {
-				std::cout << ",";
-			}
-			iter++;
-			std::cout << std::endl;
+	}
+};
+
+const char*	Table_Row<rpc::t_node>::headers[] = {
+	"DOMAIN", "NAME", "WEIGHT", "JOBS", "RESOURCES"
+};
+
+template<>
+struct Table_Row<rpc::t_resource> {
+	static const char*	headers[];
+
+	template<typename Sink>
+	static void	cell(const rpc::t_resource& resource, const size_t& column, Sink& sink) {
+		switch (column) {
+			case 0:
+				sink_string(sink, resource.name);
+				break;
+			case 1:
+				sink_integer(sink, resource.current_value);
+				break;
+			case 2:
+				sink_integer(sink, resource.initial_value);
+				break;
 		}
-		std::cout << str_indent << "]" << std::endl;
 	}
+};
+
+const char*	Table_Row<rpc::t_resource>::headers[] = {
+	"NAME", "CURRENT_VALUE", "INITIAL_VALUE"
+};
+
+static const size_t	all_columns[PRINTING_MAX_COLUMNS] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+Table_Formatter::Table_Formatter(Output_Buffer& buffer, const s_printing_options& opts, UNUSED(const uint& depth)) :
+	_buffer(buffer), _opts(opts), _fields(opts.job_fields == 0 ? JOB_FIELDS_PLAIN : opts.job_fields) {
 }
 
-void	print_node(const s_printing_options& opts, const uint& indent, const rpc::t_node& node) {
-	std::string	str_indent;
-	get_indent(opts, indent, str_indent);
+void	Table_Formatter::write(const m_kv& kv) {
+	size_t	width = 3;
+
+	for ( const auto& pair : kv ) {
+		if ( pair.first.compare("command") == 0 && this->_opts.verbose == false )
+			continue;
+		width = std::max(width, pair.first.size());
+	}
 
-	if ( opts.output_type == plain ) {
-		std::cout << str_indent << "domain:	" << node.domain_name << std::endl;
-		std::cout << str_indent << "name:	" << node.name << std::endl;
-		std::cout << str_indent << "weight:	" << node.weight << std::endl;
+	this->_buffer.append("KEY", 3);
+	this->pad(3, width);
+	this->_buffer.append("VALUE\n", 6);
 
-		std::cout << str_indent << "jobs:	" << std::endl;
-		print_jobs(opts, indent + 2, node.jobs);
+	for ( const auto& pair : kv ) {
+		if ( pair.first.compare("command") == 0 && this->_opts.verbose == false )
+			continue;
 
-		std::cout << str_indent << "resources:" << std::endl;
-		print_resources(opts, indent + 2, node.resources);
-	} else {
-		std::cout << str_indent << "{" << std::endl;
+		this->_buffer.append(pair.first);
+		this->pad(pair.first.size(), width);
+		this->_buffer.append(pair.second);
+		this->_buffer.append('\n');
+	}
+}
 
-		get_indent(opts, indent + 1, str_indent);
-		std::cout << str_indent << "'domain':'" << node.domain_name << "'," << std::endl
-				  << str_indent << "'name':'" << node.name << "'," << std::endl
-				  << str_indent << "'weight':" << node.weight << "," << std::endl;
+void	Table_Formatter::write(const rpc::v_nodes& nodes) {
+	this->write_rows(nodes.begin(), nodes.end(), all_columns, 5);
+}
 
-		std::cout << str_indent << "'jobs':";
-		print_jobs(opts, indent + 2, node.jobs);
-		std::cout << "," << std::endl
-				  << str_indent << "'resources':";
+void	Table_Formatter::write(const rpc::t_node& node) {
+	this->write_rows(&node, &node + 1, all_columns, 5);
+}
 
-		print_resources(opts, indent + 2, node.resources);
+void	Table_Formatter::write(const rpc::v_jobs& jobs) {
+	size_t	columns[PRINTING_MAX_COLUMNS];
+	size_t	count = 0;
 
-		get_indent(opts, indent, str_indent);
-		std::cout << std::endl << str_indent << "}" << std::endl;
+	for ( size_t i = 0 ; i < 12 ; ++i ) {
+		if ( this->_fields & (1 << i) )
+			columns[count++] = i;
 	}
+
+	this->write_rows(jobs.begin(), jobs.end(), columns, count);
 }
 
-void	print_jobs(const s_printing_options& opts, const uint& indent, const rpc::v_jobs& jobs) {
-	std::string	str_indent;
+void	Table_Formatter::write(const rpc::t_job& job) {
+	size_t	columns[PRINTING_MAX_COLUMNS];
+	size_t	count = 0;
+
+	for ( size_t i = 0 ; i < 12 ; ++i ) {
+		if ( this->_fields & (1 << i) )
+			columns[count++] = i;
+	}
+
+	this->write_rows(&job, &job + 1, columns, count);
+}
+
+void	Table_Formatter::write(const rpc::v_time_constraints& tcs) {
+	this->write_rows(tcs.begin(), tcs.end(), all_columns, 2);
+}
+
+void	Table_Formatter::write(const rpc::t_time_constraint& tc) {
+	this->write_rows(&tc, &tc + 1, all_columns, 2);
+}
+
+void	Table_Formatter::write(const rpc::v_resources& resources) {
+	this->write_rows(resources.begin(), resources.end(), all_columns, 3);
+}
+
+void	Table_Formatter::write(const rpc::t_resource& resource) {
+	this->write_rows(&resource, &resource + 1, all_columns, 3);
+}
+
+void	Table_Formatter::end() {
+}
+
+template<typename Iterator>
+void	Table_Formatter::write_rows(Iterator first, Iterator last, const size_t* columns, const size_t& count) {
+	typedef Table_Row<typename std::iterator_traits<Iterator>::value_type>	Row;
+	size_t	widths[PRINTING_MAX_COLUMNS];
 
-	if ( jobs.size() == 0 ) {
-		if ( opts.output_type == json )
-			std::cout << "[]";
+	if ( count == 0 )
 		return;
+
+	// First pass: the columns' widths
+	for ( size_t c = 0 ; c < count ; ++c ) {
+		widths[c] = strlen(Row::headers[columns[c]]);
 	}
 
-	get_indent(opts, indent, str_indent);
+	for ( Iterator row = first ; row != last ; ++row ) {
+		for ( size_t c = 0 ; c < count ; ++c ) {
+			Width_Sink	measure;
 
-	if ( opts.output_type == plain ) {
-		BOOST_FOREACH(rpc::t_job job, jobs) {
-			print_job(opts, indent, job);
+			Row::cell(*row, columns[c], measure);
+			widths[c] = std::max(widths[c], std::min(measure.width, this->_opts.column_width));
 		}
-	} else {
-		size_t	iter = 0;
+	}
+
+	// Second pass: the rows
+	for ( size_t c = 0 ; c < count ; ++c ) {
+		const char*	header = Row::headers[columns[c]];
+		size_t		size = strlen(header);
 
-		std::cout << "[" << std::endl;
-		BOOST_FOREACH(rpc::t_job job, jobs) {
-			print_job(opts, indent, job);
+		this->_buffer.append(header, size);
+		if ( c < count - 1 )
+			this->pad(size, widths[c]);
+	}
+	this->_buffer.append('\n');
 
-			if ( iter < jobs.size() - 1 )
-				std::cout << ",";
-			std::cout << std::endl;
-			iter++;
+	for ( Iterator row = first ; row != last ; ++row ) {
+		for ( size_t c = 0 ; c < count ; ++c ) {
+			this->write_cell(*row, columns[c], widths[c], c == count - 1);
 		}
-		get_indent(opts, indent, str_indent);
-		std::cout << str_indent << "]";
+		this->_buffer.append('\n');
 	}
 }
 
-void	print_job(const s_printing_options& opts, const uint& indent, const rpc::t_job& job) {
-	std::string	str_indent;
-	get_indent(opts, indent, str_indent);
+template<typename Row>
+void	Table_Formatter::write_cell(const Row& row, const size_t& column, const size_t& width, const bool& last) {
+	Width_Sink	measure;
+	size_t		budget = this->_opts.column_width;
+	bool		truncated = false;
 
-	if ( opts.output_type == plain ) {
-		std::cout << str_indent << "name:	" << job.name << std::endl;
-		std::cout << str_indent << "state:	" << build_string_from_job_state(job.state) << std::endl;
-		std::cout << str_indent << ":cmd_line	" << job.cmd_line << std::endl;
-	} else {
-		std::cout << str_indent
-				  << "{'name':'" << job.name
-				  << "','state':'" << build_string_from_job_state(job.state)
-				  << "','cmd_line':" << job.cmd_line
-				  << "','node_name':'" << job.node_name
-				  << ",'next':" << strings_to_string(job.nxt)
-				  << ",'prv':" << strings_to_string(job.prv)
-				  << ",'recovery_type':" << recovery_type_action_to_string(job.recovery_type)
-				  << ",'return_code':" << job.return_code
-				  << ",'start_time':" << job.start_time
-				  << ",'stop_time':" << job.stop_time
-				  << ",'time_constraints':";
-		print_time_constraints(opts, indent + 1, job.time_constraints);
-		get_indent(opts, indent, str_indent);
-		std::cout << std::endl << str_indent << ",'weight':" << job.weight << "}";
+	Table_Row<Row>::cell(row, column, measure);
+
+	if ( measure.width > this->_opts.column_width ) {
+		truncated = true;
+		if ( budget > 3 )
+			budget -= 3;
 	}
+
+	Cell_Sink	cell(this->_buffer, budget);
+	Table_Row<Row>::cell(row, column, cell);
+
+	if ( truncated == true && budget < this->_opts.column_width )
+		this->_buffer.append("...", 3);
+
+	if ( last == false )
+		this->pad(std::min(measure.width, this->_opts.column_width), width);
 }
 
-void	print_time_constraints(const s_printing_options& opts, const uint& indent, const rpc::v_time_constraints& tcs) {
-	std::string	str_indent;
+void	Table_Formatter::pad(const size_t& written, const size_t& width) {
+	static const char	spaces[] = "                                ";
+	size_t				missing = (width > written ? width - written : 0) + 2;
 
-	if ( tcs.size() == 0 ) {
-		if ( opts.output_type == json )
-			std::cout << "[]";
-		return;
+	while ( missing > 0 ) {
+		size_t	size = std::min(missing, sizeof(spaces) - 1);
+
+		this->_buffer.append(spaces, size);
+		missing -= size;
 	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//	csv
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief The Quote_Check_Sink struct
+ *
+ * Checks if the text needs to be quoted
+ */
+struct Quote_Check_Sink {
+	char	separator;
+	bool	needed;
 
-	get_indent(opts, indent, str_indent);
+	Quote_Check_Sink(const char& s) : separator(s), needed(false) {
+	}
 
-	if ( opts.output_type == plain ) {
-		BOOST_FOREACH(rpc::t_time_constraint tc, tcs) {
-			print_time_constraint(opts, indent, tc);
+	void	text(const char* data, const size_t& size) {
+		for ( const char* c = data ; c < data + size && this->needed == false ; ++c ) {
+			if ( *c == this->separator || *c == '"' || *c == '\n' || *c == '\r' )
+				this->needed = true;
 		}
-	} else {
-		std::cout << "[" << std::endl;
+	}
+};
 
-		BOOST_FOREACH(rpc::t_time_constraint tc, tcs) {
-			size_t	iter = 0;
-			print_time_constraint(opts, indent, tc);
+/**
+ * @brief The Raw_Sink struct
+ *
+ * Copies the text
+ */
+struct Raw_Sink {
+	Output_Buffer&	buffer;
+
+	Raw_Sink(Output_Buffer& b) : buffer(b) {
+	}
+
+	void	text(const char* data, const size_t& size) {
+		this->buffer.append(data, size);
+	}
+};
+
+/**
+ * @brief The Quoted_Sink struct
+ *
+ * Copies the text, doubling the quotes
+ */
+struct Quoted_Sink {
+	Output_Buffer&	buffer;
+
+	Quoted_Sink(Output_Buffer& b) : buffer(b) {
+	}
+
+	void	text(const char* data, const size_t& size) {
+		const char*	run = data;
+
+		for ( const char* c = data ; c < data + size ; ++c ) {
+			if ( *c != '"' )
+				continue;
 
-			iter++;
-			if ( iter < tcs.size() - 1 )
-				std::cout << str_indent << ",";
-			std::cout << std::endl;
+			this->buffer.append(run, c + 1 - run);
+			this->buffer.append('"');
+			run = c + 1;
 		}
+		this->buffer.append(run, data + size - run);
+	}
+};
+
+/**
+ * The jobs' free text and lists are always quoted
+ */
+#define CSV_QUOTED_JOB_FIELDS	(JOB_FIELD_CMD_LINE | JOB_FIELD_NXT | JOB_FIELD_PRV | JOB_FIELD_TIME_CONSTRAINTS)
+
+template<typename Row>
+bool	is_always_quoted(UNUSED(const Row& row), UNUSED(const size_t& column)) {
+	return false;
+}
+
+template<>
+bool	is_always_quoted(UNUSED(const rpc::t_job& job), const size_t& column) {
+	return CSV_QUOTED_JOB_FIELDS & (1 << column);
+}
+
+Csv_Formatter::Csv_Formatter(Output_Buffer& buffer, const s_printing_options& opts, UNUSED(const uint& depth), const char& separator) :
+	_buffer(buffer), _opts(opts), _separator(separator), _job_columns_count(0) {
+	uint32_t	fields = opts.job_fields == 0 ? JOB_FIELDS_ALL : opts.job_fields;
 
-		get_indent(opts, indent, str_indent);
-		std::cout << str_indent << "]";
+	for ( size_t i = 0 ; i < 12 ; ++i ) {
+		if ( fields & (1 << i) )
+			this->_job_columns[this->_job_columns_count++] = i;
 	}
 }
 
-void	print_time_constraint(const s_printing_options& opts, const uint& indent, const rpc::t_time_constraint& tc) {
-	std::string	str_indent;
-	get_indent(opts, indent, str_indent);
+void	Csv_Formatter::write(const m_kv& kv) {
+	this->_buffer.append("key", 3);
+	this->_buffer.append(this->_separator);
+	this->_buffer.append("value\n", 6);
 
-	if ( opts.output_type == plain ) {
-		std::cout << time_constraint_to_string(tc);
-	} else {
-		std::cout << str_indent
-				  << "{'type':'" << time_constraint_type_to_string(tc.type)
-				  << "', 'value':" << tc.value
-				  << "}";
+	for ( const auto& pair : kv ) {
+		Quote_Check_Sink	check(this->_separator);
+
+		if ( pair.first.compare("command") == 0 && this->_opts.verbose == false )
+			continue;
+
+		this->_buffer.append(pair.first);
+		this->_buffer.append(this->_separator);
+
+		sink_string(check, pair.second);
+		if ( check.needed == true ) {
+			Quoted_Sink	quoted(this->_buffer);
+
+			this->_buffer.append('"');
+			sink_string(quoted, pair.second);
+			this->_buffer.append('"');
+		} else {
+			this->_buffer.append(pair.second);
+		}
+		this->_buffer.append('\n');
 	}
 }
 
-void	print_resources(const s_printing_options& opts, const uint& indent, const rpc::v_resources& resources) {
-	std::string	str_indent;
+void	Csv_Formatter::write(const rpc::v_nodes& nodes) {
+	this->write_head(nodes);
+	this->write_items(nodes, 0, nodes.size());
+	this->write_tail(nodes);
+}
 
-	if ( resources.size() == 0 ) {
-		if ( opts.output_type == json )
-			std::cout << "[]";
-		return;
+void	Csv_Formatter::write(const rpc::t_node& node) {
+	this->write_header<rpc::t_node>(all_columns, 5);
+	this->write_record(node, all_columns, 5);
+}
+
+void	Csv_Formatter::write(const rpc::v_jobs& jobs) {
+	this->write_head(jobs);
+	this->write_items(jobs, 0, jobs.size());
+	this->write_tail(jobs);
+}
+
+void	Csv_Formatter::write(const rpc::t_job& job) {
+	this->write_header<rpc::t_job>(this->_job_columns, this->_job_columns_count);
+	this->write_record(job, this->_job_columns, this->_job_columns_count);
+}
+
+void	Csv_Formatter::write(const rpc::v_time_constraints& tcs) {
+	this->write_header<rpc::t_time_constraint>(all_columns, 2);
+	BOOST_FOREACH(const rpc::t_time_constraint& tc, tcs) {
+		this->write_record(tc, all_columns, 2);
 	}
+}
 
-	get_indent(opts, indent, str_indent);
+void	Csv_Formatter::write(const rpc::t_time_constraint& tc) {
+	this->write_header<rpc::t_time_constraint>(all_columns, 2);
+	this->write_record(tc, all_columns, 2);
+}
 
-	if ( opts.output_type == plain ) {
-		BOOST_FOREACH(rpc::t_resource resource, resources) {
-			print_resource(opts, indent, resource);
-		}
-	} else {
-		std::cout << "[" << std::endl;
+void	Csv_Formatter::write(const rpc::v_resources& resources) {
+	this->write_header<rpc::t_resource>(all_columns, 3);
+	BOOST_FOREACH(const rpc::t_resource& resource, resources) {
+		this->write_record(resource, all_columns, 3);
+	}
+}
+
+void	Csv_Formatter::write(const rpc::t_resource& resource) {
+	this->write_header<rpc::t_resource>(all_columns, 3);
+	this->write_record(resource, all_columns, 3);
+}
+
+void	Csv_Formatter::write_head(UNUSED(const rpc::v_nodes& nodes)) {
+	this->write_header<rpc::t_node>(all_columns, 5);
+}
 
-		BOOST_FOREACH(rpc::t_resource resource, resources) {
-			size_t	iter = 0;
-			print_resource(opts, indent, resource);
+void	Csv_Formatter::write_items(const rpc::v_nodes& nodes, const size_t& first, const size_t& last) {
+	for ( size_t i = first ; i < last ; ++i ) {
+		this->write_record(nodes[i], all_columns, 5);
+	}
+}
+
+void	Csv_Formatter::write_tail(UNUSED(const rpc::v_nodes& nodes)) {
+}
 
-			iter++;
-			if ( iter < resources.size() - 1 )
-				std::cout << str_indent << ",";
-			std::cout << std::endl;
+void	Csv_Formatter::write_head(UNUSED(const rpc::v_jobs& jobs)) {
+	this->write_header<rpc::t_job>(this->_job_columns, this->_job_columns_count);
+}
+
+void	Csv_Formatter::write_items(const rpc::v_jobs& jobs, const size_t& first, const size_t& last) {
+	for ( size_t i = first ; i < last ; ++i ) {
+		this->write_record(jobs[i], this->_job_columns, this->_job_columns_count);
+	}
+}
+
+void	Csv_Formatter::write_tail(UNUSED(const rpc::v_jobs& jobs)) {
+}
+
+void	Csv_Formatter::end() {
+}
+
+template<typename Row>
+void	Csv_Formatter::write_header(const size_t* columns, const size_t& count) {
+	for ( size_t c = 0 ; c < count ; ++c ) {
+		if ( c > 0 )
+			this->_buffer.append(this->_separator);
+
+		// The tables' headers, in lower case like the JSON keys
+		for ( const char* h = Table_Row<Row>::headers[columns[c]] ; *h != '\0' ; ++h ) {
+			this->_buffer.append(static_cast<char>(tolower(*h)));
 		}
+	}
+	this->_buffer.append('\n');
+}
 
-		get_indent(opts, indent, str_indent);
-		std::cout << str_indent << "]";
+template<typename Row>
+void	Csv_Formatter::write_record(const Row& row, const size_t* columns, const size_t& count) {
+	for ( size_t c = 0 ; c < count ; ++c ) {
+		if ( c > 0 )
+			this->_buffer.append(this->_separator);
+		this->write_value(row, columns[c]);
 	}
+	this->_buffer.append('\n');
 }
 
-void	print_resource(const s_printing_options& opts, const uint& indent, const rpc::t_resource& resource) {
-	std::string	str_indent;
-	get_indent(opts, indent, str_indent);
+template<typename Row>
+void	Csv_Formatter::write_value(const Row& row, const size_t& column) {
+	Quote_Check_Sink	check(this->_separator);
 
-	if ( opts.output_type == plain ) {
-		std::cout << str_indent << "name:	" << resource.name << std::endl;
-		std::cout << str_indent << "current value:	" << resource.current_value << std::endl;
-		std::cout << str_indent << "initial value:	" << resource.initial_value << std::endl;
-	} else {
-		std::cout << str_indent << "{'name':'" << resource.name << "','current value':" << resource.current_value << "','initial value':" << resource.initial_value << "}";
+	if ( is_always_quoted(row, column) == false )
+		Table_Row<Row>::cell(row, column, check);
+
+	if ( is_always_quoted(row, column) == false && check.needed == false ) {
+		Raw_Sink	raw(this->_buffer);
+		Table_Row<Row>::cell(row, column, raw);
+		return;
 	}
+
+	Quoted_Sink	quoted(this->_buffer);
+
+	this->_buffer.append('"');
+	Table_Row<Row>::cell(row, column, quoted);
+	this->_buffer.append('"');
+}
+
+Tsv_Formatter::Tsv_Formatter(Output_Buffer& buffer, const s_printing_options& opts, const uint& depth) :
+	Csv_Formatter(buffer, opts, depth, '\t') {
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//	binary
+///////////////////////////////////////////////////////////////////////////////
+
+Binary_Formatter::Binary_Formatter(Output_Buffer& buffer, const s_printing_options& opts, UNUSED(const uint& depth)) :
+	_buffer(buffer), _opts(opts), _transport(new Output_Transport(buffer)), _protocol(_transport) {
+}
+
+void	Binary_Formatter::write(const m_kv& kv) {
+	uint32_t	size = 0;
+
+	for ( const auto& pair : kv ) {
+		if ( pair.first.compare("command") != 0 || this->_opts.verbose == true )
+			size++;
+	}
+
+	write_snapshot_header(this->_buffer, SNAPSHOT_KV);
+	this->_protocol.writeMapBegin(apache::thrift::protocol::T_STRING, apache::thrift::protocol::T_STRING, size);
+
+	for ( const auto& pair : kv ) {
+		if ( pair.first.compare("command") == 0 && this->_opts.verbose == false )
+			continue;
+
+		this->_protocol.writeString(pair.first);
+		this->_protocol.writeString(pair.second);
+	}
+
+	this->_protocol.writeMapEnd();
+}
+
+void	Binary_Formatter::write(const rpc::v_nodes& nodes) {
+	this->write_head(nodes);
+	this->write_items(nodes, 0, nodes.size());
+	this->write_tail(nodes);
+}
+
+void	Binary_Formatter::write(const rpc::t_node& node) {
+	this->write_list(SNAPSHOT_NODES, &node, &node + 1);
+}
+
+void	Binary_Formatter::write(const rpc::v_jobs& jobs) {
+	this->write_head(jobs);
+	this->write_items(jobs, 0, jobs.size());
+	this->write_tail(jobs);
+}
+
+void	Binary_Formatter::write(const rpc::t_job& job) {
+	this->write_list(SNAPSHOT_JOBS, &job, &job + 1);
+}
+
+void	Binary_Formatter::write(const rpc::v_time_constraints& tcs) {
+	this->write_list(SNAPSHOT_TIME_CONSTRAINTS, tcs.data(), tcs.data() + tcs.size());
+}
+
+void	Binary_Formatter::write(const rpc::t_time_constraint& tc) {
+	this->write_list(SNAPSHOT_TIME_CONSTRAINTS, &tc, &tc + 1);
+}
+
+void	Binary_Formatter::write(const rpc::v_resources& resources) {
+	this->write_list(SNAPSHOT_RESOURCES, resources.data(), resources.data() + resources.size());
+}
+
+void	Binary_Formatter::write(const rpc::t_resource& resource) {
+	this->write_list(SNAPSHOT_RESOURCES, &resource, &resource + 1);
+}
+
+/*
+ * The compact protocol does not keep any state between two structures: the
+ * items can be written by different formatters.
+ */
+
+void	Binary_Formatter::write_head(const rpc::v_nodes& nodes) {
+	write_snapshot_header(this->_buffer, SNAPSHOT_NODES);
+	this->_protocol.writeListBegin(apache::thrift::protocol::T_STRUCT, nodes.size());
+}
+
+void	Binary_Formatter::write_items(const rpc::v_nodes& nodes, const size_t& first, const size_t& last) {
+	for ( size_t i = first ; i < last ; ++i ) {
+		nodes[i].write(&this->_protocol);
+	}
+}
+
+void	Binary_Formatter::write_tail(UNUSED(const rpc::v_nodes& nodes)) {
+	this->_protocol.writeListEnd();
+}
+
+void	Binary_Formatter::write_head(const rpc::v_jobs& jobs) {
+	write_snapshot_header(this->_buffer, SNAPSHOT_JOBS);
+	this->_protocol.writeListBegin(apache::thrift::protocol::T_STRUCT, jobs.size());
+}
+
+void	Binary_Formatter::write_items(const rpc::v_jobs& jobs, const size_t& first, const size_t& last) {
+	for ( size_t i = first ; i < last ; ++i ) {
+		jobs[i].write(&this->_protocol);
+	}
+}
+
+void	Binary_Formatter::write_tail(UNUSED(const rpc::v_jobs& jobs)) {
+	this->_protocol.writeListEnd();
+}
+
+void	Binary_Formatter::end() {
+}
+
+template<typename T>
+void	Binary_Formatter::write_list(const e_snapshot_type& type, const T* first, const T* last) {
+	write_snapshot_header(this->_buffer, type);
+	this->_protocol.writeListBegin(apache::thrift::protocol::T_STRUCT, last - first);
+
+	for ( const T* item = first ; item < last ; ++item ) {
+		item->write(&this->_protocol);
+	}
+
+	this->_protocol.writeListEnd();
 }
@@ -0,0 +1,147 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: rpc_cache.cpp
+ * Description: implements the cache of the read requests
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include "rpc_cache.h"
+
+Rpc_Cache::Rpc_Cache(const size_t& ttl) : _enabled(true), _ttl(std::chrono::seconds(ttl)), _hits(0), _misses(0) {
+}
+
+std::shared_ptr<const rpc::v_nodes>	Rpc_Cache::find_nodes(const rpc::t_routing_data& routing) {
+	return this->find(this->_nodes, routing);
+}
+
+std::shared_ptr<const rpc::v_nodes>	Rpc_Cache::store_nodes(const rpc::t_routing_data& routing, rpc::v_nodes& nodes) {
+	return this->store(this->_nodes, routing, nodes);
+}
+
+std::shared_ptr<const Job_List>	Rpc_Cache::find_jobs(const rpc::t_routing_data& routing) {
+	return this->find(this->_jobs, routing);
+}
+
+std::shared_ptr<const Job_List>	Rpc_Cache::store_jobs(const rpc::t_routing_data& routing, rpc::v_jobs& jobs) {
+	std::shared_ptr<const Job_List>	stored(new Job_List(jobs));
+
+	this->keep(this->_jobs, routing, stored);
+
+	return stored;
+}
+
+std::shared_ptr<const std::vector<std::string> >	Rpc_Cache::find_planning_names(const rpc::t_routing_data& routing) {
+	return this->find(this->_planning_names, routing);
+}
+
+std::shared_ptr<const std::vector<std::string> >	Rpc_Cache::store_planning_names(const rpc::t_routing_data& routing, std::vector<std::string>& names) {
+	return this->store(this->_planning_names, routing, names);
+}
+
+void	Rpc_Cache::invalidate(const std::string& domain) {
+	invalidate(this->_nodes, domain);
+	invalidate(this->_jobs, domain);
+	invalidate(this->_planning_names, domain);
+}
+
+void	Rpc_Cache::clear() {
+	this->_nodes.clear();
+	this->_jobs.clear();
+	this->_planning_names.clear();
+}
+
+void	Rpc_Cache::set_enabled(const bool& enabled) {
+	this->_enabled = enabled;
+
+	if ( enabled == false )
+		this->clear();
+}
+
+void	Rpc_Cache::set_ttl(const size_t& seconds) {
+	this->_ttl = std::chrono::seconds(seconds);
+}
+
+size_t	Rpc_Cache::hits() const {
+	return this->_hits;
+}
+
+size_t	Rpc_Cache::misses() const {
+	return this->_misses;
+}
+
+template<typename T>
+std::shared_ptr<const T>	Rpc_Cache::find(std::map<cache_key, s_cache_entry<T> >& entries, const rpc::t_routing_data& routing) {
+	typename std::map<cache_key, s_cache_entry<T> >::iterator	entry;
+
+	if ( this->_enabled == false )
+		return std::shared_ptr<const T>();
+
+	entry = entries.find(cache_key(routing.target_node.name, routing.target_node.domain_name));
+
+	if ( entry == entries.end() ) {
+		this->_misses++;
+		return std::shared_ptr<const T>();
+	}
+
+	if ( std::chrono::steady_clock::now() - entry->second.stored >= this->_ttl ) {
+		entries.erase(entry);
+		this->_misses++;
+		return std::shared_ptr<const T>();
+	}
+
+	this->_hits++;
+	return entry->second.value;
+}
+
+template<typename T>
+std::shared_ptr<const T>	Rpc_Cache::store(std::map<cache_key, s_cache_entry<T> >& entries, const rpc::t_routing_data& routing, T& value) {
+	std::shared_ptr<T>	stored(new T());
+
+	stored->swap(value);
+	this->keep(entries, routing, std::shared_ptr<const T>(stored));
+
+	return stored;
+}
+
+template<typename T>
+void	Rpc_Cache::keep(std::map<cache_key, s_cache_entry<T> >& entries, const rpc::t_routing_data& routing, const std::shared_ptr<const T>& value) {
+	if ( this->_enabled == false )
+		return;
+
+	s_cache_entry<T>&	entry = entries[cache_key(routing.target_node.name, routing.target_node.domain_name)];
+
+	entry.value = value;
+	entry.stored = std::chrono::steady_clock::now();
+}
+
+template<typename T>
+void	Rpc_Cache::invalidate(std::map<cache_key, s_cache_entry<T> >& entries, const std::string& domain) {
+	typename std::map<cache_key, s_cache_entry<T> >::iterator	entry = entries.begin();
+
+	while ( entry != entries.end() ) {
+		if ( entry->first.second == domain )
+			entries.erase(entry++);
+		else
+			++entry;
+	}
+}
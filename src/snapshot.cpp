@@ -0,0 +1,150 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: snapshot.cpp
+ * Description: implements the binary snapshots of jobs and nodes
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <cstring>
+
+#include "snapshot.h"
+
+using apache::thrift::protocol::TType;
+using apache::thrift::protocol::T_STRING;
+using apache::thrift::protocol::T_STRUCT;
+using apache::thrift::transport::TBufferedTransport;
+using apache::thrift::transport::TFDTransport;
+using apache::thrift::transport::TTransport;
+
+Output_Transport::Output_Transport(Output_Buffer& buffer) : _buffer(buffer) {
+}
+
+uint32_t	Output_Transport::read(uint8_t*, uint32_t) {
+	throw apache::thrift::transport::TTransportException("Output_Transport cannot be read");
+}
+
+void	Output_Transport::write(const uint8_t* buf, uint32_t len) {
+	this->_buffer.append(reinterpret_cast<const char*>(buf), len);
+}
+
+void	write_snapshot_header(Output_Buffer& buffer, const e_snapshot_type& type) {
+	buffer.append(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE);
+	buffer.append(static_cast<char>(SNAPSHOT_VERSION));
+	buffer.append(static_cast<char>(type));
+}
+
+Snapshot_Reader::Snapshot_Reader(const int& fd) :
+	_transport(new TBufferedTransport(boost::shared_ptr<TTransport>(new TFDTransport(fd)), OUTPUT_BUFFER_FLUSH_SIZE)),
+	_protocol(_transport) {
+}
+
+bool	Snapshot_Reader::read(s_snapshot& snapshot, bool& end) {
+	uint8_t	header[SNAPSHOT_HEADER_SIZE];
+
+	end = false;
+
+	try {
+		if ( this->_transport->peek() == false ) {
+			end = true;
+			return true;
+		}
+
+		this->_transport->readAll(header, SNAPSHOT_HEADER_SIZE);
+
+		if ( memcmp(header, SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE) != 0 ) {
+			std::cerr << "This is not a snapshot" << std::endl;
+			return false;
+		}
+
+		if ( header[SNAPSHOT_MAGIC_SIZE] != SNAPSHOT_VERSION ) {
+			std::cerr << "Unsupported snapshot version " << static_cast<int>(header[SNAPSHOT_MAGIC_SIZE]) << std::endl;
+			return false;
+		}
+
+		snapshot.type = static_cast<e_snapshot_type>(header[SNAPSHOT_MAGIC_SIZE + 1]);
+
+		switch ( snapshot.type ) {
+			case SNAPSHOT_NODES:
+				this->read_list(snapshot.nodes);
+				break;
+			case SNAPSHOT_JOBS:
+				this->read_list(snapshot.jobs);
+				break;
+			case SNAPSHOT_TIME_CONSTRAINTS:
+				this->read_list(snapshot.time_constraints);
+				break;
+			case SNAPSHOT_RESOURCES:
+				this->read_list(snapshot.resources);
+				break;
+			case SNAPSHOT_KV:
+				this->read_kv(snapshot.kv);
+				break;
+			default:
+				std::cerr << "Unknown snapshot type '" << header[SNAPSHOT_MAGIC_SIZE + 1] << "'" << std::endl;
+				return false;
+		}
+	} catch (const apache::thrift::TException& e) {
+		std::cerr << "Cannot read the snapshot: " << e.what() << std::endl;
+		return false;
+	} catch (const std::exception& e) {
+		std::cerr << "Cannot read the snapshot: " << e.what() << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+template<typename T>
+void	Snapshot_Reader::read_list(std::vector<T>& list) {
+	TType		type;
+	uint32_t	size = 0;
+
+	this->_protocol.readListBegin(type, size);
+	if ( type != T_STRUCT )
+		throw apache::thrift::protocol::TProtocolException("the list does not contain structs");
+
+	list.resize(size);
+	for ( uint32_t i = 0 ; i < size ; ++i ) {
+		list[i].read(&this->_protocol);
+	}
+
+	this->_protocol.readListEnd();
+}
+
+void	Snapshot_Reader::read_kv(m_kv& kv) {
+	TType		key_type;
+	TType		value_type;
+	uint32_t	size = 0;
+	std::string	key;
+
+	this->_protocol.readMapBegin(key_type, value_type, size);
+	if ( key_type != T_STRING || value_type != T_STRING )
+		throw apache::thrift::protocol::TProtocolException("the map does not contain strings");
+
+	for ( uint32_t i = 0 ; i < size ; ++i ) {
+		this->_protocol.readString(key);
+		this->_protocol.readString(kv[key]);
+	}
+
+	this->_protocol.readMapEnd();
+}
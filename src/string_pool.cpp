@@ -0,0 +1,147 @@
+/**
+ * Project: ows-cli: a shell client for Open Workload Scheduler
+ * File name: string_pool.cpp
+ * Description: implements the pool of interned strings
+ *
+ * @author Mathieu Grzybek on 2013-06-06
+ * @copyright 2010 Mathieu Grzybek. All rights reserved.
+ * @version $Id: code-gpl-license.txt,v 1.2 2004/05/04 13:19:30 garry Exp $
+ *
+ * @see The GNU Public License (GPL) version 3 or higher
+ *
+ *
+ * ows-cli is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License
+ * for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "string_pool.h"
+
+String_Pool::String_Pool() : _block(NULL), _block_used(STRING_POOL_BLOCK_SIZE), _arena_size(0), _table(STRING_POOL_TABLE_SIZE, STRING_POOL_NO_ID) {
+}
+
+string_id	String_Pool::intern(const boost::string_view& s) {
+	size_t	position = this->slot(s);
+
+	if ( this->_table[position] != STRING_POOL_NO_ID )
+		return this->_table[position];
+
+	this->_table[position] = static_cast<string_id>(this->_strings.size());
+	this->_strings.push_back(this->store(s));
+
+	// At most half of the slots are used
+	if ( this->_strings.size() * 2 > this->_table.size() )
+		this->grow();
+
+	return static_cast<string_id>(this->_strings.size() - 1);
+}
+
+bool	String_Pool::find(const boost::string_view& s, string_id& id) const {
+	size_t	position = this->slot(s);
+
+	if ( this->_table[position] == STRING_POOL_NO_ID )
+		return false;
+
+	id = this->_table[position];
+	return true;
+}
+
+boost::string_view	String_Pool::get(const string_id& id) const {
+	return this->_strings[id];
+}
+
+size_t	String_Pool::size() const {
+	return this->_strings.size();
+}
+
+size_t	String_Pool::memory() const {
+	return this->_arena_size +
+		this->_strings.capacity() * sizeof(boost::string_view) +
+		this->_table.capacity() * sizeof(string_id);
+}
+
+void	String_Pool::clear() {
+	this->_table.assign(STRING_POOL_TABLE_SIZE, STRING_POOL_NO_ID);
+	this->_strings.clear();
+	this->_blocks.clear();
+	this->_block = NULL;
+	this->_block_used = STRING_POOL_BLOCK_SIZE;
+	this->_arena_size = 0;
+}
+
+uint32_t	String_Pool::hash(const boost::string_view& s) {
+	uint32_t	result = 2166136261U;
+
+	for ( size_t i = 0 ; i < s.size() ; ++i ) {
+		result ^= static_cast<unsigned char>(s[i]);
+		result *= 16777619U;
+	}
+
+	return result;
+}
+
+size_t	String_Pool::slot(const boost::string_view& s) const {
+	size_t	mask = this->_table.size() - 1;
+	size_t	position = String_Pool::hash(s) & mask;
+
+	while ( this->_table[position] != STRING_POOL_NO_ID && this->_strings[this->_table[position]] != s )
+		position = (position + 1) & mask;
+
+	return position;
+}
+
+void	String_Pool::grow() {
+	size_t	mask = this->_table.size() * 2 - 1;
+
+	this->_table.assign(this->_table.size() * 2, STRING_POOL_NO_ID);
+
+	for ( string_id id = 0 ; id < this->_strings.size() ; ++id ) {
+		size_t	position = String_Pool::hash(this->_strings[id]) & mask;
+
+		while ( this->_table[position] != STRING_POOL_NO_ID )
+			position = (position + 1) & mask;
+
+		this->_table[position] = id;
+	}
+}
+
+boost::string_view	String_Pool::store(const boost::string_view& s) {
+	char*	data = NULL;
+
+	if ( s.empty() == true )
+		return boost::string_view();
+
+	// The long strings get their own block, the current one is kept
+	if ( s.size() > STRING_POOL_BLOCK_SIZE / 4 ) {
+		this->_blocks.push_back(std::unique_ptr<char[]>(new char[s.size()]));
+		this->_arena_size += s.size();
+		data = this->_blocks.back().get();
+	} else {
+		if ( this->_block_used + s.size() > STRING_POOL_BLOCK_SIZE ) {
+			this->_blocks.push_back(std::unique_ptr<char[]>(new char[STRING_POOL_BLOCK_SIZE]));
+			this->_arena_size += STRING_POOL_BLOCK_SIZE;
+			this->_block = this->_blocks.back().get();
+			this->_block_used = 0;
+		}
+
+		data = this->_block + this->_block_used;
+		this->_block_used += s.size();
+	}
+
+	memcpy(data, s.data(), s.size());
+
+	return boost::string_view(data, s.size());
+}
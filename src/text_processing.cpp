@@ -25,46 +25,155 @@
  * 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
  */
 
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
 #include "text_processing.h"
 
-std::string	recovery_type_action_to_string(const rpc::t_recovery_type& t) {
-	switch (t.action) {
-		case rpc::e_rectype_action::RESTART:
-			return "restart";
-		case rpc::e_rectype_action::STOP_SCHEDULE:
-			return "stop";
-	}
+/**
+ * @brief The s_enum_name struct
+ *
+ * An entry of the conversion tables: they are indexed by the enum's value,
+ * the alias is also accepted when parsing.
+ */
+struct s_enum_name {
+	int			value;
+	const char*	name;
+	size_t		size;
+	const char*	alias;
+};
+
+#define ENUM_NAME(value, name, alias)	{ value, name, sizeof(name) - 1, alias }
+
+static constexpr s_enum_name	job_states[] = {
+	ENUM_NAME(rpc::e_job_state::WAITING,	"waiting",		NULL),
+	ENUM_NAME(rpc::e_job_state::RUNNING,	"running",		NULL),
+	ENUM_NAME(rpc::e_job_state::SUCCEEDED,	"succeeded",	NULL),
+	ENUM_NAME(rpc::e_job_state::FAILED,		"failed",		NULL)
+};
+
+static constexpr s_enum_name	rectype_actions[] = {
+	ENUM_NAME(rpc::e_rectype_action::RESTART,		"restart",	NULL),
+	ENUM_NAME(rpc::e_rectype_action::STOP_SCHEDULE,	"stop",		"stop_schedule")
+};
+
+static constexpr s_enum_name	time_constraint_types[] = {
+	ENUM_NAME(rpc::e_time_constraint_type::AT,		"at",		NULL),
+	ENUM_NAME(rpc::e_time_constraint_type::BEFORE,	"before",	NULL),
+	ENUM_NAME(rpc::e_time_constraint_type::AFTER,	"after",	NULL)
+};
+
+#undef ENUM_NAME
+
+static_assert(job_states[rpc::e_job_state::FAILED].value == rpc::e_job_state::FAILED, "job_states must be indexed by value");
+static_assert(rectype_actions[rpc::e_rectype_action::STOP_SCHEDULE].value == rpc::e_rectype_action::STOP_SCHEDULE, "rectype_actions must be indexed by value");
+static_assert(time_constraint_types[rpc::e_time_constraint_type::AFTER].value == rpc::e_time_constraint_type::AFTER, "time_constraint_types must be indexed by value");
+
+/**
+ * enum_to_string
+ *
+ * @return	the name of the value, empty if it is out of the table
+ */
+template<size_t N>
+static inline boost::string_view	enum_to_string(const s_enum_name (&table)[N], const int& value) {
+	if ( value < 0 || static_cast<size_t>(value) >= N )
+		return boost::string_view();
+
+	return boost::string_view(table[value].name, table[value].size);
+}
+
+/**
+ * ascii_iequals
+ *
+ * Compares the names without case, the locale is not used
+ */
+static inline bool	ascii_iequals(const boost::string_view& name, const char* expected, const size_t& size) {
+	if ( name.size() != size )
+		return false;
+
+	for ( size_t i = 0 ; i < size ; ++i ) {
+		char	c = name[i];
 
-	return "";
+		if ( c >= 'A' && c <= 'Z' )
+			c += 'a' - 'A';
+
+		if ( c != expected[i] )
+			return false;
+	}
 
+	return true;
 }
 
-std::string	time_constraint_type_to_string(const rpc::e_time_constraint_type::type& t) {
-	switch (t) {
-		case rpc::e_time_constraint_type::AT:
-			return "at";
-		case rpc::e_time_constraint_type::BEFORE:
-			return "before";
-		case rpc::e_time_constraint_type::AFTER:
-			return "after";
+/**
+ * enum_from_string
+ *
+ * The tables have at most four entries, only the names of the same size are
+ * compared
+ *
+ * @return	false if the name is unknown
+ */
+template<size_t N, typename T>
+static inline bool	enum_from_string(const s_enum_name (&table)[N], const boost::string_view& name, T& value) {
+	for ( size_t i = 0 ; i < N ; ++i ) {
+		if ( ascii_iequals(name, table[i].name, table[i].size) == true ||
+			( table[i].alias != NULL && ascii_iequals(name, table[i].alias, strlen(table[i].alias)) == true ) ) {
+			value = static_cast<T>(table[i].value);
+			return true;
+		}
 	}
 
-	return "";
+	return false;
+}
+
+boost::string_view	job_state_to_string(const rpc::e_job_state::type& state) {
+	return enum_to_string(job_states, state);
+}
+
+bool	job_state_from_string(const boost::string_view& name, rpc::e_job_state::type& state) {
+	return enum_from_string(job_states, name, state);
+}
+
+boost::string_view	rectype_action_to_string(const rpc::e_rectype_action::type& action) {
+	return enum_to_string(rectype_actions, action);
+}
+
+bool	rectype_action_from_string(const boost::string_view& name, rpc::e_rectype_action::type& action) {
+	return enum_from_string(rectype_actions, name, action);
+}
+
+boost::string_view	recovery_type_action_to_string(const rpc::t_recovery_type& t) {
+	return rectype_action_to_string(t.action);
+}
+
+boost::string_view	time_constraint_type_to_string(const rpc::e_time_constraint_type::type& t) {
+	return enum_to_string(time_constraint_types, t);
+}
+
+bool	time_constraint_type_from_string(const boost::string_view& name, rpc::e_time_constraint_type::type& type) {
+	return enum_from_string(time_constraint_types, name, type);
 }
 
 std::string	time_constraint_to_string(const rpc::t_time_constraint& tc) {
 	std::string	result;
 
-	result = time_constraint_type_to_string(tc.type);
+	result = time_constraint_type_to_string(tc.type).to_string();
 	result += " ";
-	result += tc.value;
+	result += boost::lexical_cast<std::string>(tc.value);
 
 	return result;
 }
 
 std::string	strings_to_string(const std::vector<std::string>& v) {
-	std::string result = "";
-	BOOST_FOREACH(std::string s, v) {
+	std::string	result;
+	size_t		size = 0;
+
+	BOOST_FOREACH(const std::string& s, v) {
+		size += s.size() + 1;
+	}
+	result.reserve(size);
+
+	BOOST_FOREACH(const std::string& s, v) {
 		result += s;
 		result += ",";
 	}
@@ -79,89 +188,397 @@ std::string	bool_to_string(const bool& v) {
 		return std::string("false");
 }
 
-void	update_node(const std::string& key, const std::string& value, rpc::t_node& node) {
-	if ( key.compare("name") == 0 ) {
-		node.name = value;
-	} else if ( key.compare("weight") == 0 ) {
-		node.weight = boost::lexical_cast<int>(value);
-	} else if ( key.compare("domain_name") == 0 ) {
-		node.domain_name = value;
-	} else if ( key.compare("resources") == 0 ) {
-		// TODO
-	} else if ( key.compare("jobs") == 0 ) {
-		// TODO
-	}
-}
-
-void	update_job(const std::string& key, const std::string& value, rpc::t_job& job) {
-	if ( key.compare("name") == 0 ) {
-		job.name = value;
-	} else if ( key.compare("weight") == 0 ) {
-		job.weight = boost::lexical_cast<int>(value);
-//	} else if ( key.compare("domain_name") == 0 ) {
-//		job.domain = value;
-	} else if ( key.compare("cmd_line") == 0 ) {
-		job.cmd_line = value;
-	} else if ( key.compare("node_name") == 0 ) {
-		job.node_name = value;
-	} else if ( key.compare("nxt") == 0 ) {
-		boost::split(job.nxt, value, boost::is_any_of(",;"));
-	} else if ( key.compare("prv") == 0 ) {
-		boost::split(job.prv, value, boost::is_any_of(",;"));
-	} if ( key.compare("recovery_type") == 0 ) {
-		std::vector<std::string>	splitted_rt;
-
-		boost::split(splitted_rt, value, boost::is_any_of(":"));
-
-		job.recovery_type.short_label = splitted_rt.at(0);
-		job.recovery_type.label = splitted_rt.at(1);
-		job.recovery_type.action = build_rectype_action_from_string(splitted_rt.at(2).c_str());
-
-	} if ( key.compare("time_constraints") == 0 ) {
-		std::vector<std::string>	list_of_tc;
-		boost::split(list_of_tc, value, boost::is_any_of(",;"));
-
-		BOOST_FOREACH(std::string tc, list_of_tc) {
-			std::vector<std::string>	splitted_tc;
-			rpc::t_time_constraint		time_constraint;
-
-			boost::algorithm::split(splitted_tc, tc, boost::is_any_of(":"));
-			time_constraint.job_name = job.name;
-			time_constraint.type = build_time_constraint_type_from_string(splitted_tc.at(0).c_str());
-			time_constraint.value = build_unix_time_from_hhmm_time(splitted_tc.at(1));
-
-			job.time_constraints.push_back(time_constraint);
+bool	build_job_fields_from_string(const std::string& list, uint32_t& fields) {
+	static const struct {
+		const char*	name;
+		uint32_t	field;
+	} names[] = {
+		{ "all",				JOB_FIELDS_ALL },
+		{ "name",				JOB_FIELD_NAME },
+		{ "state",				JOB_FIELD_STATE },
+		{ "cmd_line",			JOB_FIELD_CMD_LINE },
+		{ "node_name",			JOB_FIELD_NODE_NAME },
+		{ "nxt",				JOB_FIELD_NXT },
+		{ "prv",				JOB_FIELD_PRV },
+		{ "recovery_type",		JOB_FIELD_RECOVERY_TYPE },
+		{ "return_code",		JOB_FIELD_RETURN_CODE },
+		{ "start_time",			JOB_FIELD_START_TIME },
+		{ "stop_time",			JOB_FIELD_STOP_TIME },
+		{ "time_constraints",	JOB_FIELD_TIME_CONSTRAINTS },
+		{ "weight",				JOB_FIELD_WEIGHT }
+	};
+	size_t	begin = 0;
+
+	fields = 0;
+
+	while ( begin <= list.size() ) {
+		size_t	end = list.find(',', begin);
+		bool	found = false;
+
+		if ( end == std::string::npos )
+			end = list.size();
+
+		for ( size_t i = 0 ; i < sizeof(names) / sizeof(names[0]) ; ++i ) {
+			if ( list.compare(begin, end - begin, names[i].name) == 0 ) {
+				fields |= names[i].field;
+				found = true;
+				break;
+			}
+		}
+
+		if ( found == false ) {
+			std::cerr << "Unknown field '" << list.substr(begin, end - begin) << "'" << std::endl;
+			return false;
 		}
+
+		begin = end + 1;
 	}
+
+	return true;
 }
 
-bool	split_line(const char& separator, const std::string& data, std::string& key, std::string& value) {
-	boost::regex	spaces("[[:space:]]+", boost::regex::perl);
-	boost::regex	comment_endl("#.*?$", boost::regex::perl);
+static const struct {
+	const char*		name;
+	e_output_type	type;
+} output_types[] = {
+	{ "plain",	plain },
+	{ "json",	json },
+	{ "ndjson",	ndjson },
+	{ "table",	table },
+	{ "csv",	csv },
+	{ "tsv",	tsv },
+	{ "binary",	binary }
+};
+
+bool	build_output_type_from_string(const std::string& name, e_output_type& type) {
+	for ( size_t i = 0 ; i < sizeof(output_types) / sizeof(output_types[0]) ; ++i ) {
+		if ( name.compare(output_types[i].name) == 0 ) {
+			type = output_types[i].type;
+			return true;
+		}
+	}
 
-	std::string	line = data;
-	size_t		position = 0;
+	return false;
+}
 
-	line = boost::regex_replace(line, spaces, "");
-	line = boost::regex_replace(line, comment_endl, "");
+const char*	output_type_to_string(const e_output_type& type) {
+	for ( size_t i = 0 ; i < sizeof(output_types) / sizeof(output_types[0]) ; ++i ) {
+		if ( output_types[i].type == type )
+			return output_types[i].name;
+	}
 
-	if ( line.length() == 0 )
-		return true;
+	return "unknown";
+}
+
+/**
+ * attribute_hash
+ *
+ * The length and the first character of the attribute names are enough to
+ * tell them apart: the switch below does not build if two names collide.
+ */
+static constexpr uint32_t	attribute_hash(const size_t length, const char first) {
+	return static_cast<uint32_t>(length) << 8 | static_cast<unsigned char>(first);
+}
+
+#define ATTRIBUTE_CASE(name, attribute) \
+	case attribute_hash(sizeof(name) - 1, name[0]): \
+		return memcmp(key.data(), name, sizeof(name) - 1) == 0 ? attribute : ATTRIBUTE_UNKNOWN;
+
+e_attribute	find_attribute(const boost::string_view& key) {
+	if ( key.empty() == true )
+		return ATTRIBUTE_UNKNOWN;
+
+	switch ( attribute_hash(key.size(), key[0]) ) {
+		ATTRIBUTE_CASE("name", ATTRIBUTE_NAME)
+		ATTRIBUTE_CASE("weight", ATTRIBUTE_WEIGHT)
+		ATTRIBUTE_CASE("domain_name", ATTRIBUTE_DOMAIN_NAME)
+		ATTRIBUTE_CASE("resources", ATTRIBUTE_RESOURCES)
+		ATTRIBUTE_CASE("jobs", ATTRIBUTE_JOBS)
+		ATTRIBUTE_CASE("cmd_line", ATTRIBUTE_CMD_LINE)
+		ATTRIBUTE_CASE("node_name", ATTRIBUTE_NODE_NAME)
+		ATTRIBUTE_CASE("nxt", ATTRIBUTE_NXT)
+		ATTRIBUTE_CASE("prv", ATTRIBUTE_PRV)
+		ATTRIBUTE_CASE("recovery_type", ATTRIBUTE_RECOVERY_TYPE)
+		ATTRIBUTE_CASE("time_constraints", ATTRIBUTE_TIME_CONSTRAINTS)
+		ATTRIBUTE_CASE("domain", ATTRIBUTE_DOMAIN)
+		ATTRIBUTE_CASE("state", ATTRIBUTE_STATE)
+		ATTRIBUTE_CASE("return_code", ATTRIBUTE_RETURN_CODE)
+		ATTRIBUTE_CASE("start_time", ATTRIBUTE_START_TIME)
+		ATTRIBUTE_CASE("stop_time", ATTRIBUTE_STOP_TIME)
+		ATTRIBUTE_CASE("short_label", ATTRIBUTE_SHORT_LABEL)
+		ATTRIBUTE_CASE("label", ATTRIBUTE_LABEL)
+		ATTRIBUTE_CASE("action", ATTRIBUTE_ACTION)
+		ATTRIBUTE_CASE("type", ATTRIBUTE_TYPE)
+		ATTRIBUTE_CASE("value", ATTRIBUTE_VALUE)
+		ATTRIBUTE_CASE("current_value", ATTRIBUTE_CURRENT_VALUE)
+		ATTRIBUTE_CASE("initial_value", ATTRIBUTE_INITIAL_VALUE)
+	}
+
+	return ATTRIBUTE_UNKNOWN;
+}
+
+#undef ATTRIBUTE_CASE
+
+bool	parse_hhmm(const boost::string_view& text, int& minutes) {
+	int	digits[4];
+	int	count = 0;
+
+	// hhmm or hh:mm
+	if ( text.size() != 4 && ( text.size() != 5 || text[2] != ':' ) )
+		return false;
+
+	for ( size_t i = 0 ; i < text.size() ; ++i ) {
+		if ( i == 2 && text.size() == 5 )
+			continue;
+
+		if ( text[i] < '0' || text[i] > '9' )
+			return false;
+
+		digits[count++] = text[i] - '0';
+	}
+
+	int	hours = digits[0] * 10 + digits[1];
+	int	mins = digits[2] * 10 + digits[3];
+
+	if ( hours > 23 || mins > 59 )
+		return false;
+
+	minutes = hours * 60 + mins;
+
+	return true;
+}
+
+time_t	resolve_hhmm(const int& minutes) {
+	// The short string does not allocate
+	char	hhmm[5] = {
+		static_cast<char>('0' + minutes / 600),
+		static_cast<char>('0' + minutes / 60 % 10),
+		static_cast<char>('0' + minutes % 60 / 10),
+		static_cast<char>('0' + minutes % 10),
+		'\0'
+	};
+
+	return build_unix_time_from_hhmm_time(std::string(hhmm, 4));
+}
+
+Hhmm_Cache::Hhmm_Cache() {
+	std::fill(this->_resolved, this->_resolved + HHMM_MINUTES_PER_DAY, false);
+}
+
+time_t	Hhmm_Cache::resolve(const int& minutes) {
+	if ( this->_resolved[minutes] == false ) {
+		this->_times[minutes] = resolve_hhmm(minutes);
+		this->_resolved[minutes] = true;
+	}
+
+	return this->_times[minutes];
+}
+
+/**
+ * is_list_separator
+ */
+static inline bool	is_list_separator(const char& c) {
+	return c == ',' || c == ';';
+}
+
+bool	update_node(const std::string& key, const std::string& value, rpc::t_node& node) {
+	switch ( find_attribute(key) ) {
+		case ATTRIBUTE_NAME:
+			node.name = value;
+			break;
+		case ATTRIBUTE_WEIGHT:
+			node.weight = boost::lexical_cast<int>(value);
+			break;
+		case ATTRIBUTE_DOMAIN_NAME:
+			node.domain_name = value;
+			break;
+		case ATTRIBUTE_RESOURCES:
+			// TODO
+			break;
+		case ATTRIBUTE_JOBS:
+			// TODO
+			break;
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+bool	update_job(const std::string& key, const std::string& value, rpc::t_job& job, Hhmm_Cache* cache) {
+	switch ( find_attribute(key) ) {
+		case ATTRIBUTE_NAME:
+			job.name = value;
+			break;
+		case ATTRIBUTE_WEIGHT:
+			job.weight = boost::lexical_cast<int>(value);
+			break;
+		case ATTRIBUTE_DOMAIN_NAME:
+			// The job belongs to the connected domain
+			break;
+		case ATTRIBUTE_CMD_LINE:
+			job.cmd_line = value;
+			break;
+		case ATTRIBUTE_NODE_NAME:
+			job.node_name = value;
+			break;
+		case ATTRIBUTE_NXT:
+			boost::split(job.nxt, value, boost::is_any_of(",;"));
+			BOOST_FOREACH(std::string& name, job.nxt) {
+				boost::trim(name);
+			}
+			break;
+		case ATTRIBUTE_PRV:
+			boost::split(job.prv, value, boost::is_any_of(",;"));
+			BOOST_FOREACH(std::string& name, job.prv) {
+				boost::trim(name);
+			}
+			break;
+		case ATTRIBUTE_RECOVERY_TYPE: {
+			std::vector<std::string>	splitted_rt;
+
+			boost::split(splitted_rt, value, boost::is_any_of(":"));
+
+			if ( splitted_rt.size() != 3 )
+				throw std::invalid_argument("expected short_label:label:action");
+
+			job.recovery_type.short_label = splitted_rt[0];
+			job.recovery_type.label = splitted_rt[1];
+			if ( rectype_action_from_string(splitted_rt[2], job.recovery_type.action) == false )
+				throw std::invalid_argument("unknown recovery action '" + splitted_rt[2] + "'");
+			break;
+		}
+		case ATTRIBUTE_TIME_CONSTRAINTS: {
+			const char*	begin = value.data();
+			const char*	end = value.data() + value.size();
+			bool		more = true;
+
+			// type:hhmm items separated by ',' or ';'
+			while ( more == true ) {
+				const char*				item_end = std::find_if(begin, end, is_list_separator);
+				boost::string_view		item = trim(begin, item_end);
+				const char*				colon = std::find(item.begin(), item.end(), ':');
+				rpc::t_time_constraint	time_constraint;
+				int						minutes = 0;
+
+				// The last item ends at end: begin must not go past it
+				more = item_end != end;
+				if ( more == true )
+					begin = item_end + 1;
+
+				if ( item.empty() == true )
+					continue;
+
+				if ( colon == item.end() )
+					throw std::invalid_argument("expected type:hhmm, got '" + item.to_string() + "'");
+
+				boost::string_view	type = trim(item.begin(), colon);
+				boost::string_view	hhmm = trim(colon + 1, item.end());
 
-	position = line.find_first_of(separator);
+				if ( time_constraint_type_from_string(type, time_constraint.type) == false )
+					throw std::invalid_argument("unknown time constraint type '" + type.to_string() + "'");
 
-	if ( position == std::string::npos ) {
-		std::cerr << "No separator '" << separator << "' found" << std::endl;
+				if ( parse_hhmm(hhmm, minutes) == false )
+					throw std::invalid_argument("bad time '" + hhmm.to_string() + "', expected hhmm or hh:mm");
+
+				time_constraint.job_name = job.name;
+				time_constraint.value = cache == NULL ? resolve_hhmm(minutes) : cache->resolve(minutes);
+
+				job.time_constraints.push_back(time_constraint);
+			}
+			break;
+		}
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * The characters ignored around the keys and the values
+ */
+static inline bool	is_blank(const char& c) {
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+bool	split_line(const char& separator, const boost::string_view& data, boost::string_view& key, boost::string_view& value) {
+	const char*	error = NULL;
+
+	if ( split_line(separator, data, key, value, error) == false ) {
+		std::cerr << error << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool	split_line(const char& separator, const boost::string_view& data, boost::string_view& key, boost::string_view& value, const char*& error) {
+	const char*	begin = data.data();
+	const char*	end = data.data() + data.size();
+	const char*	position = NULL;
+	const char*	c = begin;
+	bool		after_blank = true;
+
+	key.clear();
+	value.clear();
+
+	// One pass: the first separator and the beginning of the comment
+	for ( ; c < end ; ++c ) {
+		if ( *c == '#' && after_blank == true )
+			break;
+
+		if ( *c == separator && position == NULL )
+			position = c;
+
+		after_blank = is_blank(*c);
+	}
+	end = c;
+
+	while ( begin < end && is_blank(*begin) )
+		++begin;
+
+	// Empty line or comment
+	if ( begin == end )
+		return true;
+
+	if ( position == NULL ) {
+		error = "No separator found";
 		return false;
 	}
 
-	key	= line.substr(0, position);
-	value	= line.substr(position+1, line.length());
+	key = trim(begin, position);
+	value = trim(position + 1, end);
 
-	if ( key.length() == 0 or value.length() == 0 ) {
-		std::cerr << "Bad input data (key or value empty)" << std::endl;
+	if ( key.empty() == true || value.empty() == true ) {
+		error = "Bad input data (key or value empty)";
+		key.clear();
+		value.clear();
 		return false;
 	}
 
 	return true;
 }
+
+bool	split_line(const char& separator, const std::string& data, std::string& key, std::string& value) {
+	boost::string_view	key_view;
+	boost::string_view	value_view;
+
+	if ( split_line(separator, boost::string_view(data), key_view, value_view) == false )
+		return false;
+
+	key.assign(key_view.data(), key_view.size());
+	value.assign(value_view.data(), value_view.size());
+
+	return true;
+}
+
+boost::string_view	trim(const char* begin, const char* end) {
+	while ( begin < end && is_blank(*begin) )
+		++begin;
+
+	while ( end > begin && is_blank(*(end - 1)) )
+		--end;
+
+	return boost::string_view(begin, end - begin);
+}